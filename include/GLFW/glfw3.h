@@ -517,6 +517,13 @@ extern "C" {
 
 #define GLFW_KEY_LAST               GLFW_KEY_MENU
 
+/*! @brief The number of words in a keyboard state bitset.
+ *
+ *  The number of 64-bit words in a keyboard state bitset, as filled by @ref
+ *  glfwGetKeyboardState.
+ */
+#define GLFW_KEYBOARD_STATE_WORDS   ((GLFW_KEY_LAST + 64) / 64)
+
 /*! @} */
 
 /*! @defgroup mods Modifier key flags
@@ -860,6 +867,12 @@ extern "C" {
  *  [window attribute](@ref GLFW_FOCUS_ON_SHOW_attrib).
  */
 #define GLFW_FOCUS_ON_SHOW          0x0002000C
+/*! @brief Event coalescing window hint and attribute
+ *
+ *  Event coalescing [window hint](@ref GLFW_COALESCE_EVENTS_hint) or
+ *  [window attribute](@ref GLFW_COALESCE_EVENTS_attrib).
+ */
+#define GLFW_COALESCE_EVENTS        0x0002000D
 
 /*! @brief Framebuffer bit depth hint.
  *
@@ -1051,6 +1064,7 @@ extern "C" {
 #define GLFW_STICKY_MOUSE_BUTTONS   0x00033003
 #define GLFW_LOCK_KEY_MODS          0x00033004
 #define GLFW_RAW_MOUSE_MOTION       0x00033005
+#define GLFW_EVENT_QUEUE            0x00033006
 
 #define GLFW_CURSOR_NORMAL          0x00034001
 #define GLFW_CURSOR_HIDDEN          0x00034002
@@ -1107,6 +1121,100 @@ extern "C" {
 #define GLFW_CONNECTED              0x00040001
 #define GLFW_DISCONNECTED           0x00040002
 
+/*! @defgroup event_types Event types
+ *  @brief Types of buffered events.
+ *
+ *  See [buffered events](@ref event_queue) for how these are used.
+ *
+ *  @ingroup input
+ *  @{ */
+
+/*! @brief A key was pressed, repeated or released.
+ */
+#define GLFW_EVENT_KEY                    0x00037001
+/*! @brief A Unicode character was input.
+ */
+#define GLFW_EVENT_CHAR                   0x00037002
+/*! @brief A mouse button was pressed or released.
+ */
+#define GLFW_EVENT_MOUSE_BUTTON           0x00037003
+/*! @brief The cursor was moved.
+ */
+#define GLFW_EVENT_CURSOR_POS             0x00037004
+/*! @brief The cursor entered or left the content area.
+ */
+#define GLFW_EVENT_CURSOR_ENTER           0x00037005
+/*! @brief A scrolling device was used.
+ */
+#define GLFW_EVENT_SCROLL                 0x00037006
+/*! @brief The window was moved.
+ */
+#define GLFW_EVENT_WINDOW_POS             0x00037007
+/*! @brief The window was resized.
+ */
+#define GLFW_EVENT_WINDOW_SIZE            0x00037008
+/*! @brief The framebuffer was resized.
+ */
+#define GLFW_EVENT_FRAMEBUFFER_SIZE       0x00037009
+/*! @brief The user attempted to close the window.
+ */
+#define GLFW_EVENT_WINDOW_CLOSE           0x0003700A
+/*! @brief The content area of the window needs to be redrawn.
+ */
+#define GLFW_EVENT_WINDOW_REFRESH         0x0003700B
+/*! @brief The window gained or lost input focus.
+ */
+#define GLFW_EVENT_WINDOW_FOCUS           0x0003700C
+/*! @brief The window was iconified or restored.
+ */
+#define GLFW_EVENT_WINDOW_ICONIFY         0x0003700D
+/*! @brief The window was maximized or restored.
+ */
+#define GLFW_EVENT_WINDOW_MAXIMIZE        0x0003700E
+/*! @brief The content scale of the window changed.
+ */
+#define GLFW_EVENT_WINDOW_CONTENT_SCALE   0x0003700F
+/*! @brief A user event was posted to the window.
+ */
+#define GLFW_EVENT_USER                   0x00037010
+/*! @} */
+
+/*! @brief Replay input at the speed it was recorded.
+ *
+ *  Replay input at the [speed it was recorded](@ref input_replay).
+ */
+#define GLFW_REPLAY_RECORDED_SPEED  0x00038001
+/*! @brief Replay one recorded frame of input per event processing call.
+ *
+ *  Replay one recorded frame of input per
+ *  [event processing call](@ref input_replay).
+ */
+#define GLFW_REPLAY_MAXIMUM_SPEED   0x00038002
+
+/*! @brief The number of cursor positions kept per window.
+ *
+ *  The maximum number of samples returned by @ref glfwGetCursorHistory.
+ */
+#define GLFW_CURSOR_HISTORY_SIZE    256
+
+/*! @brief The number of frame timings kept per window.
+ *
+ *  The maximum number of timings returned by @ref glfwGetFrameTimings.
+ */
+#define GLFW_FRAME_TIMINGS_SIZE     64
+
+/*! @brief The frame was shown later than the swap interval allows.
+ *
+ *  The frame was shown more vertical blanks after the previous frame than the
+ *  [swap interval](@ref buffer_swap) allows.
+ */
+#define GLFW_FRAME_MISSED_VBLANK    0x00000001
+/*! @brief The frame was never shown.
+ *
+ *  The frame was replaced by a later frame before it could be shown.
+ */
+#define GLFW_FRAME_SKIPPED          0x00000002
+
 /*! @addtogroup init
  *  @{ */
 /*! @brief Joystick hat buttons init hint.
@@ -1124,6 +1232,11 @@ extern "C" {
  *  macOS specific [init hint](@ref GLFW_COCOA_MENUBAR_hint).
  */
 #define GLFW_COCOA_MENUBAR          0x00051002
+/*! @brief X11 specific init hint.
+ *
+ *  X11 specific [init hint](@ref GLFW_X11_EVENT_THREAD_hint).
+ */
+#define GLFW_X11_EVENT_THREAD       0x00052001
 /*! @} */
 
 #define GLFW_DONT_CARE              -1
@@ -1411,6 +1524,120 @@ typedef void (* GLFWframebuffersizefun)(GLFWwindow* window, int width, int heigh
  */
 typedef void (* GLFWwindowcontentscalefun)(GLFWwindow* window, float xscale, float yscale);
 
+/*! @brief The function pointer type for user event callbacks.
+ *
+ *  This is the function pointer type for user event callbacks.  A user event
+ *  callback function has the following signature:
+ *  @code
+ *  void function_name(GLFWwindow* window, uint64_t payload)
+ *  @endcode
+ *
+ *  @param[in] window The window the event was posted to.
+ *  @param[in] payload The payload passed to @ref glfwPostUserEvent.
+ *
+ *  @sa @ref events_user
+ *  @sa @ref glfwSetUserEventCallback
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup window
+ */
+typedef void (* GLFWusereventfun)(GLFWwindow* window, uint64_t payload);
+
+/*! @brief The function pointer type for file descriptor callbacks.
+ *
+ *  This is the function pointer type for file descriptor callbacks.  A file
+ *  descriptor callback function has the following signature:
+ *  @code
+ *  void function_name(int fd)
+ *  @endcode
+ *
+ *  @param[in] fd The file descriptor that is ready for reading.
+ *
+ *  @sa @ref events_fd
+ *  @sa @ref glfwAddWaitFd
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup window
+ */
+typedef void (* GLFWwaitfdfun)(int fd);
+
+/*! @brief The function pointer type for clipboard data callbacks.
+ *
+ *  This is the function pointer type for clipboard data callbacks.  A clipboard
+ *  data callback function has the following signature:
+ *  @code
+ *  int function_name(const void* data, size_t size, void* user)
+ *  @endcode
+ *
+ *  @param[in] data The next chunk of clipboard data.
+ *  @param[in] size The size, in bytes, of the chunk.
+ *  @param[in] user The user pointer passed to @ref glfwGetClipboardDataStream.
+ *  @return `GLFW_TRUE` to receive the next chunk, or `GLFW_FALSE` to cancel the
+ *  transfer.
+ *
+ *  @pointer_lifetime The chunk is valid until the callback returns.
+ *
+ *  @sa @ref clipboard_stream
+ *  @sa @ref glfwGetClipboardDataStream
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup input
+ */
+typedef int (* GLFWclipboarddatafun)(const void* data, size_t size, void* user);
+
+/*! @brief The function pointer type for clipboard source callbacks.
+ *
+ *  This is the function pointer type for clipboard source callbacks.  A
+ *  clipboard source callback function has the following signature:
+ *  @code
+ *  size_t function_name(void* buffer, size_t offset, size_t size, void* user)
+ *  @endcode
+ *
+ *  @param[out] buffer Where to write the requested part of the data, or `NULL`
+ *  if the data is no longer needed and may be released.
+ *  @param[in] offset The offset, in bytes, of the requested part of the data.
+ *  @param[in] size The size, in bytes, of the buffer.
+ *  @param[in] user The user pointer passed to @ref glfwSetClipboardDataSource.
+ *  @return The number of bytes written to the buffer.  Returning fewer bytes
+ *  than requested ends the transfer.
+ *
+ *  @pointer_lifetime The buffer is valid until the callback returns.
+ *
+ *  @sa @ref clipboard_source
+ *  @sa @ref glfwSetClipboardDataSource
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup input
+ */
+typedef size_t (* GLFWclipboardsourcefun)(void* buffer, size_t offset, size_t size, void* user);
+
+/*! @brief The function pointer type for clipboard string callbacks.
+ *
+ *  This is the function pointer type for clipboard string callbacks.  A
+ *  clipboard string callback function has the following signature:
+ *  @code
+ *  void function_name(const char* string, void* user)
+ *  @endcode
+ *
+ *  @param[in] string The contents of the clipboard as a UTF-8 encoded string,
+ *  or `NULL` if the clipboard is empty or its contents could not be converted.
+ *  @param[in] user The user pointer passed to @ref glfwRequestClipboardString.
+ *
+ *  @pointer_lifetime The string is valid until the callback returns.
+ *
+ *  @sa @ref clipboard_request
+ *  @sa @ref glfwRequestClipboardString
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup input
+ */
+typedef void (* GLFWclipboardstringfun)(const char* string, void* user);
+
 /*! @brief The function pointer type for mouse button callbacks.
  *
  *  This is the function pointer type for mouse button callback functions.
@@ -1754,6 +1981,106 @@ typedef struct GLFWgamepadstate
     float axes[6];
 } GLFWgamepadstate;
 
+/*! @brief Buffered event.
+ *
+ *  This describes a single event retrieved from the event queue of a window.
+ *  The member of `data` that is valid is determined by the event type.  The
+ *  members have the same meaning as the arguments of the corresponding
+ *  callback.
+ *
+ *  @sa @ref event_queue
+ *  @sa @ref glfwGetEvents
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup input
+ */
+typedef struct GLFWevent
+{
+    /*! The [type](@ref event_types) of the event.
+     */
+    int type;
+    /*! The [raw timer](@ref event_time) value at which the event occurred.
+     */
+    uint64_t time;
+    /*! The type-specific data of the event.
+     */
+    union
+    {
+        struct { int key; int scancode; int action; int mods; } key;
+        struct { unsigned int codepoint; } character;
+        struct { int button; int action; int mods; } mouseButton;
+        struct { double x; double y; } cursorPos;
+        struct { int entered; } cursorEnter;
+        struct { double x; double y; } scroll;
+        struct { int x; int y; } windowPos;
+        struct { int width; int height; } windowSize;
+        struct { int width; int height; } framebufferSize;
+        struct { int focused; } windowFocus;
+        struct { int iconified; } windowIconify;
+        struct { int maximized; } windowMaximize;
+        struct { float x; float y; } windowContentScale;
+        struct { uint64_t payload; } user;
+    } data;
+} GLFWevent;
+
+/*! @brief Cursor position sample.
+ *
+ *  This describes a single cursor position received by a window.
+ *
+ *  @sa @ref cursor_history
+ *  @sa @ref glfwGetCursorHistory
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup input
+ */
+typedef struct GLFWcursorsample
+{
+    /*! The x-coordinate of the cursor, relative to the left edge of the content
+     *  area.
+     */
+    double x;
+    /*! The y-coordinate of the cursor, relative to the top edge of the content
+     *  area.
+     */
+    double y;
+    /*! The [raw timer](@ref event_time) value at which the position was
+     *  received.
+     */
+    uint64_t time;
+} GLFWcursorsample;
+
+/*! @brief Frame timing.
+ *
+ *  This describes when a single frame of a window was submitted and when it was
+ *  shown on screen.
+ *
+ *  @sa @ref frame_timing
+ *  @sa @ref glfwGetFrameTimings
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup window
+ */
+typedef struct GLFWframetiming
+{
+    /*! The [raw timer](@ref time) value at which @ref glfwSwapBuffers was
+     *  called for the frame, or zero if the frame was not submitted through
+     *  GLFW.
+     */
+    uint64_t submitTime;
+    /*! The [raw timer](@ref time) value at which the frame was shown.
+     */
+    uint64_t presentTime;
+    /*! The vertical blank counter of the monitor at which the frame was shown.
+     */
+    uint64_t msc;
+    /*! Zero or more of `GLFW_FRAME_MISSED_VBLANK` and `GLFW_FRAME_SKIPPED`.
+     */
+    int flags;
+} GLFWframetiming;
+
 
 /*************************************************************************
  * GLFW API functions
@@ -2855,6 +3182,10 @@ GLFWAPI void glfwSetWindowIcon(GLFWwindow* window, int count, const GLFWimage* i
  *  position of its windows, this function will always emit @ref
  *  GLFW_PLATFORM_ERROR.
  *
+ *  @remark @x11 This function returns the position from the most recently
+ *  processed event and does not query the X server.  A position set with @ref
+ *  glfwSetWindowPos is reported once the resulting event has been processed.
+ *
  *  @thread_safety This function must only be called from the main thread.
  *
  *  @sa @ref window_pos
@@ -2919,6 +3250,10 @@ GLFWAPI void glfwSetWindowPos(GLFWwindow* window, int xpos, int ypos);
  *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED and @ref
  *  GLFW_PLATFORM_ERROR.
  *
+ *  @remark @x11 This function returns the size from the most recently
+ *  processed event and does not query the X server.  A size set with @ref
+ *  glfwSetWindowSize is reported once the resulting event has been processed.
+ *
  *  @thread_safety This function must only be called from the main thread.
  *
  *  @sa @ref window_size
@@ -3514,6 +3849,11 @@ GLFWAPI void glfwSetWindowMonitor(GLFWwindow* window, GLFWmonitor* monitor, int
  *  errors.  However, this function should not fail as long as it is passed
  *  valid arguments and the library has been [initialized](@ref intro_init).
  *
+ *  @remark @x11 The `GLFW_FOCUSED`, `GLFW_ICONIFIED`, `GLFW_MAXIMIZED` and
+ *  `GLFW_HOVERED` attributes reflect the most recently processed events and do
+ *  not query the X server.  A change requested by the application is reported
+ *  once the window manager has carried it out.
+ *
  *  @thread_safety This function must only be called from the main thread.
  *
  *  @sa @ref window_attribs
@@ -3533,8 +3873,9 @@ GLFWAPI int glfwGetWindowAttrib(GLFWwindow* window, int attrib);
  *  The supported attributes are [GLFW_DECORATED](@ref GLFW_DECORATED_attrib),
  *  [GLFW_RESIZABLE](@ref GLFW_RESIZABLE_attrib),
  *  [GLFW_FLOATING](@ref GLFW_FLOATING_attrib),
- *  [GLFW_AUTO_ICONIFY](@ref GLFW_AUTO_ICONIFY_attrib) and
- *  [GLFW_FOCUS_ON_SHOW](@ref GLFW_FOCUS_ON_SHOW_attrib).
+ *  [GLFW_AUTO_ICONIFY](@ref GLFW_AUTO_ICONIFY_attrib),
+ *  [GLFW_FOCUS_ON_SHOW](@ref GLFW_FOCUS_ON_SHOW_attrib) and
+ *  [GLFW_COALESCE_EVENTS](@ref GLFW_COALESCE_EVENTS_attrib).
  *
  *  Some of these attributes are ignored for full screen windows.  The new
  *  value will take effect if the window is later made windowed.
@@ -3563,6 +3904,98 @@ GLFWAPI int glfwGetWindowAttrib(GLFWwindow* window, int attrib);
  */
 GLFWAPI void glfwSetWindowAttrib(GLFWwindow* window, int attrib, int value);
 
+/*! @brief Returns the pixel buffer of the specified window.
+ *
+ *  This function returns the pixel buffer to draw the next frame of the
+ *  specified window into, for windows without a client API that are rendered
+ *  by the CPU.  Call @ref glfwPresentPixelBuffer to show the drawn pixels.
+ *
+ *  The buffer matches the current size of the window and each pixel is
+ *  a 32-bit value in native byte order with the red, green and blue channels
+ *  in bits 16-23, 8-15 and 0-7.  For windows with a transparent framebuffer
+ *  the alpha channel is in bits 24-31, otherwise those bits are ignored.
+ *
+ *  The buffer retains the contents of the previously presented frame, so only
+ *  the changed areas need to be drawn.  If the window has been resized since
+ *  the last call, a new buffer is created and its contents are cleared to zero.
+ *
+ *  If an [error](@ref error_handling) occurs, all non-`NULL` size arguments
+ *  will be set to zero and `NULL` is returned.
+ *
+ *  @param[in] window The window whose pixel buffer to return.
+ *  @param[out] width Where to store the width, in pixels, of the buffer, or
+ *  `NULL`.
+ *  @param[out] height Where to store the height, in pixels, of the buffer, or
+ *  `NULL`.
+ *  @param[out] stride Where to store the distance, in bytes, between the
+ *  starts of consecutive rows of the buffer, or `NULL`.
+ *  @return The pixel buffer, or `NULL` if an [error](@ref error_handling)
+ *  occurred.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED, @ref
+ *  GLFW_INVALID_VALUE, @ref GLFW_FORMAT_UNAVAILABLE, @ref GLFW_OUT_OF_MEMORY
+ *  and @ref GLFW_PLATFORM_ERROR.
+ *
+ *  @remark The window must have been created with the
+ *  [GLFW_CLIENT_API](@ref GLFW_CLIENT_API_hint) hint set to `GLFW_NO_API`.
+ *
+ *  @remark @x11 The buffer is shared with the X server via the MIT-SHM
+ *  extension and double buffered.  This function may block until the server
+ *  has finished reading the buffer from the frame before last.  If MIT-SHM is
+ *  not available, for example on a remote display, a single buffer is used and
+ *  its pixels are sent over the connection.
+ *
+ *  @remark @wayland @win32 @macos Pixel buffers are not yet implemented on
+ *  these platforms and this function emits @ref GLFW_PLATFORM_ERROR.
+ *
+ *  @pointer_lifetime The returned buffer is allocated and freed by GLFW.  You
+ *  should not free it yourself.  It is valid until the next call to @ref
+ *  glfwPresentPixelBuffer or this function for the same window, or until the
+ *  window is destroyed.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref window_pixels
+ *  @sa @ref glfwPresentPixelBuffer
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup window
+ */
+GLFWAPI unsigned char* glfwGetWindowPixelBuffer(GLFWwindow* window, int* width, int* height, int* stride);
+
+/*! @brief Shows the pixel buffer of the specified window.
+ *
+ *  This function shows the specified areas of the pixel buffer most recently
+ *  returned by @ref glfwGetWindowPixelBuffer for the specified window.  Each
+ *  area is specified by four integers, the x- and y-coordinates of its
+ *  upper-left corner followed by its width and height, in pixels.  Areas
+ *  extending outside the buffer are clipped.
+ *
+ *  If the count is zero, the whole buffer is shown.
+ *
+ *  @param[in] window The window whose pixel buffer to show.
+ *  @param[in] rects The areas that have changed since the last frame, or
+ *  `NULL` if the count is zero.
+ *  @param[in] count The number of areas in the array.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED, @ref
+ *  GLFW_INVALID_VALUE, @ref GLFW_OUT_OF_MEMORY and @ref GLFW_PLATFORM_ERROR.
+ *
+ *  @remark @wayland @win32 @macos Pixel buffers are not yet implemented on
+ *  these platforms and this function emits @ref GLFW_PLATFORM_ERROR.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref window_pixels
+ *  @sa @ref glfwGetWindowPixelBuffer
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup window
+ */
+GLFWAPI void glfwPresentPixelBuffer(GLFWwindow* window, const int* rects, int count);
+
 /*! @brief Sets the user pointer of the specified window.
  *
  *  This function sets the user-defined pointer of the specified window.  The
@@ -3909,6 +4342,38 @@ GLFWAPI GLFWframebuffersizefun glfwSetFramebufferSizeCallback(GLFWwindow* window
  */
 GLFWAPI GLFWwindowcontentscalefun glfwSetWindowContentScaleCallback(GLFWwindow* window, GLFWwindowcontentscalefun callback);
 
+/*! @brief Sets the user event callback for the specified window.
+ *
+ *  This function sets the user event callback of the specified window, which
+ *  is called on the main thread for each event posted to the window with @ref
+ *  glfwPostUserEvent.
+ *
+ *  @param[in] window The window whose callback to set.
+ *  @param[in] callback The new callback, or `NULL` to remove the currently set
+ *  callback.
+ *  @return The previously set callback, or `NULL` if no callback was set or the
+ *  library had not been [initialized](@ref intro_init).
+ *
+ *  @callback_signature
+ *  @code
+ *  void function_name(GLFWwindow* window, uint64_t payload)
+ *  @endcode
+ *  For more information about the callback parameters, see the
+ *  [function pointer type](@ref GLFWusereventfun).
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref events_user
+ *  @sa @ref glfwPostUserEvent
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup window
+ */
+GLFWAPI GLFWusereventfun glfwSetUserEventCallback(GLFWwindow* window, GLFWusereventfun callback);
+
 /*! @brief Processes all pending events.
  *
  *  This function processes only those events that are already in the event
@@ -4041,6 +4506,44 @@ GLFWAPI void glfwWaitEvents(void);
  */
 GLFWAPI void glfwWaitEventsTimeout(double timeout);
 
+/*! @brief Waits until events are queued or a deadline is reached and processes
+ *  them.
+ *
+ *  This function puts the calling thread to sleep until at least one event is
+ *  available in the event queue, or until the [raw timer](@ref time) reaches
+ *  the specified value.  Otherwise it behaves exactly like @ref
+ *  glfwWaitEventsTimeout.
+ *
+ *  Unlike a relative timeout, the deadline does not drift when the wait is
+ *  interrupted and resumed, which makes it suitable for waking up at a
+ *  precomputed time such as the next vertical blank.  If the deadline has
+ *  already passed, this function behaves like @ref glfwPollEvents.
+ *
+ *  @param[in] value The value of the raw timer, as returned by @ref
+ *  glfwGetTimerValue, at which to stop waiting.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED and @ref
+ *  GLFW_PLATFORM_ERROR.
+ *
+ *  @remark @x11 @wayland The deadline is waited for with nanosecond precision
+ *  where `ppoll` is available and millisecond precision otherwise.
+ *
+ *  @remark @win32 @macos The deadline is converted to a relative timeout.
+ *
+ *  @reentrancy This function must not be called from a callback.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref events
+ *  @sa @ref glfwWaitEventsTimeout
+ *  @sa @ref glfwGetTimerValue
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup window
+ */
+GLFWAPI void glfwWaitEventsUntil(uint64_t value);
+
 /*! @brief Posts an empty event to the event queue.
  *
  *  This function posts an empty event from the current thread to the event
@@ -4061,63 +4564,160 @@ GLFWAPI void glfwWaitEventsTimeout(double timeout);
  */
 GLFWAPI void glfwPostEmptyEvent(void);
 
-/*! @brief Returns the value of an input option for the specified window.
+/*! @brief Posts a user event with a payload to the specified window.
  *
- *  This function returns the value of an input option for the specified window.
- *  The mode must be one of @ref GLFW_CURSOR, @ref GLFW_STICKY_KEYS,
- *  @ref GLFW_STICKY_MOUSE_BUTTONS, @ref GLFW_LOCK_KEY_MODS or
- *  @ref GLFW_RAW_MOUSE_MOTION.
+ *  This function posts a user event carrying the specified payload from the
+ *  current thread to the specified window.  The event is delivered on the main
+ *  thread by the next call to @ref glfwPollEvents, @ref glfwWaitEvents or @ref
+ *  glfwWaitEventsTimeout, which calls the
+ *  [user event callback](@ref glfwSetUserEventCallback) of the window.  If that
+ *  function is waiting for events, it will return.
  *
- *  @param[in] window The window to query.
- *  @param[in] mode One of `GLFW_CURSOR`, `GLFW_STICKY_KEYS`,
- *  `GLFW_STICKY_MOUSE_BUTTONS`, `GLFW_LOCK_KEY_MODS` or
- *  `GLFW_RAW_MOUSE_MOTION`.
+ *  User events posted to a window are delivered in the order they were posted.
+ *  Posting an event is cheap and does not involve the window system; only the
+ *  first event posted while the main thread has not yet processed earlier ones
+ *  will wake it up.
+ *
+ *  @param[in] window The window to post the event to.
+ *  @param[in] payload The application-defined payload of the event.
  *
  *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED and @ref
- *  GLFW_INVALID_ENUM.
+ *  GLFW_PLATFORM_ERROR.
  *
- *  @thread_safety This function must only be called from the main thread.
+ *  @pointer_lifetime The window must not be destroyed while this function is
+ *  executing.  Events still pending when the window is destroyed are
+ *  discarded.
  *
- *  @sa @ref glfwSetInputMode
+ *  @thread_safety This function may be called from any thread.
  *
- *  @since Added in version 3.0.
+ *  @sa @ref events_user
+ *  @sa @ref glfwSetUserEventCallback
+ *  @sa @ref glfwPostEmptyEvent
  *
- *  @ingroup input
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup window
  */
-GLFWAPI int glfwGetInputMode(GLFWwindow* window, int mode);
+GLFWAPI void glfwPostUserEvent(GLFWwindow* window, uint64_t payload);
 
-/*! @brief Sets an input option for the specified window.
+/*! @brief Adds a file descriptor to those waited on for events.
  *
- *  This function sets an input mode option for the specified window.  The mode
- *  must be one of @ref GLFW_CURSOR, @ref GLFW_STICKY_KEYS,
- *  @ref GLFW_STICKY_MOUSE_BUTTONS, @ref GLFW_LOCK_KEY_MODS or
- *  @ref GLFW_RAW_MOUSE_MOTION.
+ *  This function adds the specified file descriptor to those that @ref
+ *  glfwWaitEvents and @ref glfwWaitEventsTimeout wait on, so that data arriving
+ *  on it causes them to return.  The specified callback is called by @ref
+ *  glfwPollEvents, @ref glfwWaitEvents and @ref glfwWaitEventsTimeout whenever
+ *  the file descriptor is ready for reading, hung up or in an error state.
  *
- *  If the mode is `GLFW_CURSOR`, the value must be one of the following cursor
- *  modes:
- *  - `GLFW_CURSOR_NORMAL` makes the cursor visible and behaving normally.
- *  - `GLFW_CURSOR_HIDDEN` makes the cursor invisible when it is over the
- *    content area of the window but does not restrict the cursor from leaving.
- *  - `GLFW_CURSOR_DISABLED` hides and grabs the cursor, providing virtual
- *    and unlimited cursor movement.  This is useful for implementing for
- *    example 3D camera controls.
+ *  If the file descriptor has already been added, its callback is replaced.
  *
- *  If the mode is `GLFW_STICKY_KEYS`, the value must be either `GLFW_TRUE` to
- *  enable sticky keys, or `GLFW_FALSE` to disable it.  If sticky keys are
- *  enabled, a key press will ensure that @ref glfwGetKey returns `GLFW_PRESS`
- *  the next time it is called even if the key had been released before the
- *  call.  This is useful when you are only interested in whether keys have been
- *  pressed but not when or in which order.
+ *  Readiness is level-triggered, so the callback will be called again by the
+ *  next event processing call unless it reads all available data.  A file
+ *  descriptor must be removed with @ref glfwRemoveWaitFd before it is closed.
  *
- *  If the mode is `GLFW_STICKY_MOUSE_BUTTONS`, the value must be either
- *  `GLFW_TRUE` to enable sticky mouse buttons, or `GLFW_FALSE` to disable it.
- *  If sticky mouse buttons are enabled, a mouse button press will ensure that
- *  @ref glfwGetMouseButton returns `GLFW_PRESS` the next time it is called even
- *  if the mouse button had been released before the call.  This is useful when
- *  you are only interested in whether mouse buttons have been pressed but not
- *  when or in which order.
+ *  @param[in] fd The file descriptor to add, for example a socket, pipe or
+ *  timer.
+ *  @param[in] callback The function to call when the file descriptor is
+ *  ready.
+ *  @return `GLFW_TRUE` if successful, or `GLFW_FALSE` if an
+ *  [error](@ref error_handling) occurred.
  *
- *  If the mode is `GLFW_LOCK_KEY_MODS`, the value must be either `GLFW_TRUE` to
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED, @ref
+ *  GLFW_INVALID_VALUE, @ref GLFW_OUT_OF_MEMORY and @ref GLFW_PLATFORM_ERROR.
+ *
+ *  @remark @win32 @macos This function is not supported and emits @ref
+ *  GLFW_PLATFORM_ERROR.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref events_fd
+ *  @sa @ref glfwRemoveWaitFd
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup window
+ */
+GLFWAPI int glfwAddWaitFd(int fd, GLFWwaitfdfun callback);
+
+/*! @brief Removes a file descriptor from those waited on for events.
+ *
+ *  This function removes a file descriptor added with @ref glfwAddWaitFd.  Its
+ *  callback will no longer be called.  Removing a file descriptor that was not
+ *  added does nothing.
+ *
+ *  @param[in] fd The file descriptor to remove.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED.
+ *
+ *  @reentrancy This function may be called from a file descriptor callback.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref events_fd
+ *  @sa @ref glfwAddWaitFd
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup window
+ */
+GLFWAPI void glfwRemoveWaitFd(int fd);
+
+/*! @brief Returns the value of an input option for the specified window.
+ *
+ *  This function returns the value of an input option for the specified window.
+ *  The mode must be one of @ref GLFW_CURSOR, @ref GLFW_STICKY_KEYS,
+ *  @ref GLFW_STICKY_MOUSE_BUTTONS, @ref GLFW_LOCK_KEY_MODS,
+ *  @ref GLFW_RAW_MOUSE_MOTION or @ref GLFW_EVENT_QUEUE.
+ *
+ *  @param[in] window The window to query.
+ *  @param[in] mode One of `GLFW_CURSOR`, `GLFW_STICKY_KEYS`,
+ *  `GLFW_STICKY_MOUSE_BUTTONS`, `GLFW_LOCK_KEY_MODS`, `GLFW_RAW_MOUSE_MOTION`
+ *  or `GLFW_EVENT_QUEUE`.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED and @ref
+ *  GLFW_INVALID_ENUM.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref glfwSetInputMode
+ *
+ *  @since Added in version 3.0.
+ *
+ *  @ingroup input
+ */
+GLFWAPI int glfwGetInputMode(GLFWwindow* window, int mode);
+
+/*! @brief Sets an input option for the specified window.
+ *
+ *  This function sets an input mode option for the specified window.  The mode
+ *  must be one of @ref GLFW_CURSOR, @ref GLFW_STICKY_KEYS,
+ *  @ref GLFW_STICKY_MOUSE_BUTTONS, @ref GLFW_LOCK_KEY_MODS,
+ *  @ref GLFW_RAW_MOUSE_MOTION or @ref GLFW_EVENT_QUEUE.
+ *
+ *  If the mode is `GLFW_CURSOR`, the value must be one of the following cursor
+ *  modes:
+ *  - `GLFW_CURSOR_NORMAL` makes the cursor visible and behaving normally.
+ *  - `GLFW_CURSOR_HIDDEN` makes the cursor invisible when it is over the
+ *    content area of the window but does not restrict the cursor from leaving.
+ *  - `GLFW_CURSOR_DISABLED` hides and grabs the cursor, providing virtual
+ *    and unlimited cursor movement.  This is useful for implementing for
+ *    example 3D camera controls.
+ *
+ *  If the mode is `GLFW_STICKY_KEYS`, the value must be either `GLFW_TRUE` to
+ *  enable sticky keys, or `GLFW_FALSE` to disable it.  If sticky keys are
+ *  enabled, a key press will ensure that @ref glfwGetKey returns `GLFW_PRESS`
+ *  the next time it is called even if the key had been released before the
+ *  call.  This is useful when you are only interested in whether keys have been
+ *  pressed but not when or in which order.
+ *
+ *  If the mode is `GLFW_STICKY_MOUSE_BUTTONS`, the value must be either
+ *  `GLFW_TRUE` to enable sticky mouse buttons, or `GLFW_FALSE` to disable it.
+ *  If sticky mouse buttons are enabled, a mouse button press will ensure that
+ *  @ref glfwGetMouseButton returns `GLFW_PRESS` the next time it is called even
+ *  if the mouse button had been released before the call.  This is useful when
+ *  you are only interested in whether mouse buttons have been pressed but not
+ *  when or in which order.
+ *
+ *  If the mode is `GLFW_LOCK_KEY_MODS`, the value must be either `GLFW_TRUE` to
  *  enable lock key modifier bits, or `GLFW_FALSE` to disable them.  If enabled,
  *  callbacks that receive modifier bits will also have the @ref
  *  GLFW_MOD_CAPS_LOCK bit set when the event was generated with Caps Lock on,
@@ -4129,10 +4729,16 @@ GLFWAPI int glfwGetInputMode(GLFWwindow* window, int mode);
  *  attempting to set this will emit @ref GLFW_PLATFORM_ERROR.  Call @ref
  *  glfwRawMouseMotionSupported to check for support.
  *
+ *  If the mode is `GLFW_EVENT_QUEUE`, the value must be either `GLFW_TRUE` to
+ *  enable the event queue of the window, or `GLFW_FALSE` to disable it and
+ *  discard any events still in it.  While enabled, events for the window are
+ *  added to the queue in addition to being passed to any callbacks.  Call @ref
+ *  glfwGetEvents to retrieve them.
+ *
  *  @param[in] window The window whose input mode to set.
  *  @param[in] mode One of `GLFW_CURSOR`, `GLFW_STICKY_KEYS`,
- *  `GLFW_STICKY_MOUSE_BUTTONS`, `GLFW_LOCK_KEY_MODS` or
- *  `GLFW_RAW_MOUSE_MOTION`.
+ *  `GLFW_STICKY_MOUSE_BUTTONS`, `GLFW_LOCK_KEY_MODS`, `GLFW_RAW_MOUSE_MOTION`
+ *  or `GLFW_EVENT_QUEUE`.
  *  @param[in] value The new value of the specified input mode.
  *
  *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED, @ref
@@ -4338,6 +4944,140 @@ GLFWAPI int glfwGetKey(GLFWwindow* window, int key);
  */
 GLFWAPI int glfwGetMouseButton(GLFWwindow* window, int button);
 
+/*! @brief Retrieves a packed snapshot of the state of all keyboard keys for the
+ *  specified window.
+ *
+ *  This function fills a bitset with the last state reported for every
+ *  [keyboard key](@ref keys) to the specified window.  The bit for a key is
+ *  bit `key % 64` of word `key / 64`, and is set if the key is pressed.  This
+ *  lets you test many keys at once with bitwise operations instead of calling
+ *  @ref glfwGetKey for each of them.
+ *
+ *  If `changed` is not `NULL`, it is filled with a bitset of the same layout
+ *  with the bits set for every key whose state differs from its state at the
+ *  start of the last call to an [event processing](@ref events) function.
+ *
+ *  If the @ref GLFW_STICKY_KEYS input mode is enabled, keys that were pressed
+ *  are reported as pressed once, even if they have already been released,
+ *  just like with @ref glfwGetKey.
+ *
+ *  @param[in] window The desired window.
+ *  @param[out] state Where to store the key states, an array of @ref
+ *  GLFW_KEYBOARD_STATE_WORDS words.
+ *  @param[out] changed Where to store the changed keys, an array of @ref
+ *  GLFW_KEYBOARD_STATE_WORDS words, or `NULL`.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref input_key
+ *  @sa @ref glfwGetKey
+ *  @sa @ref glfwGetMouseState
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup input
+ */
+GLFWAPI void glfwGetKeyboardState(GLFWwindow* window, uint64_t* state, uint64_t* changed);
+
+/*! @brief Retrieves a packed snapshot of the state of all mouse buttons for the
+ *  specified window.
+ *
+ *  This function retrieves a bit mask of the last state reported for every
+ *  [mouse button](@ref buttons) to the specified window.  The bit for a button
+ *  is `1 << button`, and is set if the button is pressed.
+ *
+ *  If `changed` is not `NULL`, it is set to a bit mask of the buttons whose
+ *  state differs from their state at the start of the last call to an
+ *  [event processing](@ref events) function.
+ *
+ *  If the @ref GLFW_STICKY_MOUSE_BUTTONS input mode is enabled, buttons that
+ *  were pressed are reported as pressed once, even if they have already been
+ *  released, just like with @ref glfwGetMouseButton.
+ *
+ *  @param[in] window The desired window.
+ *  @param[out] state Where to store the button states.
+ *  @param[out] changed Where to store the changed buttons, or `NULL`.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref input_mouse_button
+ *  @sa @ref glfwGetMouseButton
+ *  @sa @ref glfwGetKeyboardState
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup input
+ */
+GLFWAPI void glfwGetMouseState(GLFWwindow* window, unsigned int* state, unsigned int* changed);
+
+/*! @brief Retrieves the number of presses and releases of the specified keys
+ *  during the last event processing.
+ *
+ *  This function retrieves how many times each of the specified keys was
+ *  pressed and released during the last call to an
+ *  [event processing](@ref events) function.  Unlike the key state, this
+ *  reveals keys that were both pressed and released during a single call,
+ *  without needing a key callback.  Key repeats are not counted as presses.
+ *
+ *  The counts are reset at the start of each call to an event processing
+ *  function and saturate at 255.
+ *
+ *  @param[in] window The desired window.
+ *  @param[in] keys The [keyboard keys](@ref keys) to query.  `GLFW_KEY_UNKNOWN`
+ *  is not a valid key for this function.
+ *  @param[in] count The number of keys to query.
+ *  @param[out] presses Where to store the number of presses of each key, or
+ *  `NULL`.
+ *  @param[out] releases Where to store the number of releases of each key, or
+ *  `NULL`.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED and @ref
+ *  GLFW_INVALID_ENUM.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref input_key
+ *  @sa @ref glfwGetMouseButtonTransitions
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup input
+ */
+GLFWAPI void glfwGetKeyTransitions(GLFWwindow* window, const int* keys, int count, int* presses, int* releases);
+
+/*! @brief Retrieves the number of presses and releases of every mouse button
+ *  during the last event processing.
+ *
+ *  This function retrieves how many times each [mouse button](@ref buttons) was
+ *  pressed and released during the last call to an
+ *  [event processing](@ref events) function.
+ *
+ *  The counts are reset at the start of each call to an event processing
+ *  function and saturate at 255.
+ *
+ *  @param[in] window The desired window.
+ *  @param[out] presses Where to store the number of presses, an array of
+ *  `GLFW_MOUSE_BUTTON_LAST + 1` elements indexed by button, or `NULL`.
+ *  @param[out] releases Where to store the number of releases, an array of
+ *  `GLFW_MOUSE_BUTTON_LAST + 1` elements indexed by button, or `NULL`.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref input_mouse_button
+ *  @sa @ref glfwGetKeyTransitions
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup input
+ */
+GLFWAPI void glfwGetMouseButtonTransitions(GLFWwindow* window, int* presses, int* releases);
+
 /*! @brief Retrieves the position of the cursor relative to the content area of
  *  the window.
  *
@@ -4365,10 +5105,16 @@ GLFWAPI int glfwGetMouseButton(GLFWwindow* window, int button);
  *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED and @ref
  *  GLFW_PLATFORM_ERROR.
  *
+ *  @remark @x11 This function returns the position from the most recently
+ *  processed event and does not query the X server.  While the cursor is
+ *  outside the window, this is where it left the content area.  Use @ref
+ *  glfwQueryCursorPosExact if you need the current position.
+ *
  *  @thread_safety This function must only be called from the main thread.
  *
  *  @sa @ref cursor_pos
  *  @sa @ref glfwSetCursorPos
+ *  @sa @ref glfwQueryCursorPosExact
  *
  *  @since Added in version 3.0.  Replaces `glfwGetMousePos`.
  *
@@ -4376,6 +5122,78 @@ GLFWAPI int glfwGetMouseButton(GLFWwindow* window, int button);
  */
 GLFWAPI void glfwGetCursorPos(GLFWwindow* window, double* xpos, double* ypos);
 
+/*! @brief Queries the current position of the cursor relative to the content
+ *  area of the window.
+ *
+ *  This function returns the position of the cursor like @ref
+ *  glfwGetCursorPos, but asks the window system for it instead of using the
+ *  position from the most recently processed event.  This can be slow, for
+ *  example when the X server is accessed over a network, so only use it when
+ *  the position must be current.
+ *
+ *  If the cursor is disabled (with `GLFW_CURSOR_DISABLED`) then this function
+ *  returns the same unbounded position as @ref glfwGetCursorPos.
+ *
+ *  Any or all of the position arguments may be `NULL`.  If an error occurs, all
+ *  non-`NULL` position arguments will be set to zero.
+ *
+ *  @param[in] window The desired window.
+ *  @param[out] xpos Where to store the cursor x-coordinate, relative to the
+ *  left edge of the content area, or `NULL`.
+ *  @param[out] ypos Where to store the cursor y-coordinate, relative to the to
+ *  top edge of the content area, or `NULL`.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED and @ref
+ *  GLFW_PLATFORM_ERROR.
+ *
+ *  @remark @win32 @macos @wayland This function is equivalent to @ref
+ *  glfwGetCursorPos.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref cursor_pos
+ *  @sa @ref glfwGetCursorPos
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup input
+ */
+GLFWAPI void glfwQueryCursorPosExact(GLFWwindow* window, double* xpos, double* ypos);
+
+/*! @brief Retrieves the cursor positions received during the last event
+ *  processing.
+ *
+ *  This function copies the cursor positions received by the specified window
+ *  during the last call to @ref glfwPollEvents, @ref glfwWaitEvents or @ref
+ *  glfwWaitEventsTimeout, oldest first, including those that were coalesced or
+ *  reported to the [cursor position callback](@ref cursor_pos).  Each sample
+ *  has the same coordinates as the corresponding callback call and the time at
+ *  which it was received.
+ *
+ *  The window keeps the most recent @ref GLFW_CURSOR_HISTORY_SIZE samples.  If
+ *  more positions were received, or more samples are available than `max`, the
+ *  oldest ones are skipped.
+ *
+ *  @param[in] window The desired window.
+ *  @param[out] samples Where to store the samples.
+ *  @param[in] max The maximum number of samples to store.
+ *  @return The number of samples stored, or zero if an
+ *  [error](@ref error_handling) occurred.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED and @ref
+ *  GLFW_INVALID_VALUE.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref cursor_history
+ *  @sa @ref glfwGetCursorPos
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup input
+ */
+GLFWAPI int glfwGetCursorHistory(GLFWwindow* window, GLFWcursorsample* samples, int max);
+
 /*! @brief Sets the position of the cursor, relative to the content area of the
  *  window.
  *
@@ -4837,6 +5655,178 @@ GLFWAPI GLFWscrollfun glfwSetScrollCallback(GLFWwindow* window, GLFWscrollfun ca
  */
 GLFWAPI GLFWdropfun glfwSetDropCallback(GLFWwindow* window, GLFWdropfun callback);
 
+/*! @brief Retrieves buffered events from the event queue of the specified
+ *  window.
+ *
+ *  This function moves up to the specified number of events, oldest first,
+ *  from the event queue of the specified window to the provided array and
+ *  returns the number of events retrieved.  Events not retrieved remain in the
+ *  queue until the next call.
+ *
+ *  The event queue must first be enabled with the
+ *  [GLFW_EVENT_QUEUE](@ref GLFW_EVENT_QUEUE) input mode.  Events are added to
+ *  the queue during [event processing](@ref events).  Path drop events are not
+ *  queued and are only reported via the [drop callback](@ref path_drop).
+ *
+ *  The queue holds a fixed number of events.  If it fills up, the oldest
+ *  events are discarded to make room for new ones.
+ *
+ *  @param[in] window The window whose events to retrieve.
+ *  @param[out] events The array to receive the events.
+ *  @param[in] capacity The maximum number of events to retrieve.
+ *  @return The number of events retrieved, or zero if the queue was empty,
+ *  not enabled or an [error](@ref error_handling) occurred.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED and @ref
+ *  GLFW_INVALID_VALUE.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref event_queue
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup input
+ */
+GLFWAPI int glfwGetEvents(GLFWwindow* window, GLFWevent* events, int capacity);
+
+/*! @brief Starts recording input to the specified file.
+ *
+ *  This function starts recording the window and joystick input received by
+ *  GLFW to a compact timestamped binary file at the specified path, replacing
+ *  any existing file.  If a recording is already in progress, it is stopped
+ *  first.  The recording can be replayed with @ref glfwStartInputReplay.
+ *
+ *  Key, character, mouse button, cursor position, cursor enter, scroll,
+ *  window position, size, framebuffer size, focus, iconification,
+ *  maximization, content scale and close request events are recorded, as are
+ *  joystick axis, button and hat changes.  The end of each call to an
+ *  [event processing](@ref events) function is also recorded.
+ *
+ *  @param[in] path The UTF-8 encoded path of the file to record to.
+ *  @return `GLFW_TRUE` if successful, or `GLFW_FALSE` if an
+ *  [error](@ref error_handling) occurred.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED and @ref
+ *  GLFW_PLATFORM_ERROR.
+ *
+ *  @remark Windows are identified in the recording by the order in which they
+ *  were created since GLFW was initialized.
+ *
+ *  @remark Path drop events are not recorded.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref input_replay
+ *  @sa @ref glfwStopInputRecording
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup input
+ */
+GLFWAPI int glfwStartInputRecording(const char* path);
+
+/*! @brief Stops recording input.
+ *
+ *  This function stops the input recording in progress, if any, and closes
+ *  its file.  Recording is also stopped by @ref glfwTerminate.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED and @ref
+ *  GLFW_PLATFORM_ERROR.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref input_replay
+ *  @sa @ref glfwStartInputRecording
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup input
+ */
+GLFWAPI void glfwStopInputRecording(void);
+
+/*! @brief Starts replaying input from the specified recording.
+ *
+ *  This function starts replaying the input recorded by @ref
+ *  glfwStartInputRecording to the specified file.  If a replay is already in
+ *  progress, it is stopped first.
+ *
+ *  Recorded events are passed through the same code paths as input from the
+ *  window system by the [event processing](@ref events) functions, which call
+ *  the same callbacks and update the same state.  With @ref
+ *  GLFW_REPLAY_RECORDED_SPEED, events are replayed once as much time has
+ *  passed since the start of the replay as had passed since the start of the
+ *  recording.  With @ref GLFW_REPLAY_MAXIMUM_SPEED, each call to an event
+ *  processing function replays the events of one recorded call.
+ *
+ *  Events for windows or joysticks that do not exist are skipped.  The replay
+ *  ends when all events have been replayed.
+ *
+ *  @param[in] path The UTF-8 encoded path of the recording to replay.
+ *  @param[in] speed `GLFW_REPLAY_RECORDED_SPEED` or
+ *  `GLFW_REPLAY_MAXIMUM_SPEED`.
+ *  @return `GLFW_TRUE` if successful, or `GLFW_FALSE` if an
+ *  [error](@ref error_handling) occurred.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED, @ref
+ *  GLFW_INVALID_ENUM, @ref GLFW_INVALID_VALUE and @ref GLFW_PLATFORM_ERROR.
+ *
+ *  @remark Input from the window system is still processed during a replay.
+ *  The null platform has no such input, making replays on it deterministic.
+ *
+ *  @remark Joystick input is only replayed to joysticks that are connected,
+ *  and is overwritten by their state when it is next polled.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref input_replay
+ *  @sa @ref glfwStopInputReplay
+ *  @sa @ref glfwInputReplayActive
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup input
+ */
+GLFWAPI int glfwStartInputReplay(const char* path, int speed);
+
+/*! @brief Stops replaying input.
+ *
+ *  This function stops the input replay in progress, if any, and closes its
+ *  file.  Replay is also stopped by @ref glfwTerminate.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref input_replay
+ *  @sa @ref glfwStartInputReplay
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup input
+ */
+GLFWAPI void glfwStopInputReplay(void);
+
+/*! @brief Returns whether an input replay is in progress.
+ *
+ *  This function returns whether an input replay started with @ref
+ *  glfwStartInputReplay is still in progress.  A replay ends when all its
+ *  events have been replayed, when it is stopped or when an error occurs.
+ *
+ *  @return `GLFW_TRUE` if a replay is in progress, or `GLFW_FALSE` otherwise.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref input_replay
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup input
+ */
+GLFWAPI int glfwInputReplayActive(void);
+
 /*! @brief Returns whether the specified joystick is present.
  *
  *  This function returns whether the specified joystick is present.
@@ -5337,6 +6327,124 @@ GLFWAPI void glfwSetClipboardString(GLFWwindow* window, const char* string);
  */
 GLFWAPI const char* glfwGetClipboardString(GLFWwindow* window);
 
+/*! @brief Requests the contents of the clipboard as a string.
+ *
+ *  This function requests the contents of the system clipboard as a UTF-8
+ *  encoded string and returns immediately.  The specified callback is called
+ *  with the string once it has arrived, from within the event processing
+ *  functions like @ref glfwPollEvents.  Unlike @ref glfwGetClipboardString,
+ *  this does not stall the calling thread while the clipboard owner is slow to
+ *  reply.
+ *
+ *  If the clipboard is empty or its contents cannot be converted, the callback
+ *  is called with `NULL` and a @ref GLFW_FORMAT_UNAVAILABLE error is
+ *  generated.  Requests still pending when the library is terminated are never
+ *  completed.
+ *
+ *  @param[in] callback The function to call with the string.
+ *  @param[in] user An arbitrary pointer passed to the callback.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED, @ref
+ *  GLFW_FORMAT_UNAVAILABLE and @ref GLFW_PLATFORM_ERROR.
+ *
+ *  @remark @win32 @macos Asynchronous clipboard requests are not yet
+ *  implemented on these platforms and this function emits @ref
+ *  GLFW_PLATFORM_ERROR.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref clipboard_request
+ *  @sa @ref glfwGetClipboardString
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup input
+ */
+GLFWAPI void glfwRequestClipboardString(GLFWclipboardstringfun callback, void* user);
+
+/*! @brief Retrieves the contents of the clipboard in chunks.
+ *
+ *  This function retrieves the contents of the system clipboard in the
+ *  specified MIME type and passes it to the specified callback one chunk at
+ *  a time, as it arrives.  The contents are never held in memory as a whole by
+ *  GLFW.  The callback can cancel the transfer by returning `GLFW_FALSE`.
+ *
+ *  This function returns once the transfer has completed, failed or been
+ *  cancelled.  If the clipboard is empty or its contents are not available in
+ *  the specified type, a @ref GLFW_FORMAT_UNAVAILABLE error is generated.
+ *
+ *  @param[in] mime The MIME type to retrieve the contents as.
+ *  @param[in] callback The function to call with each chunk.
+ *  @param[in] user An arbitrary pointer passed to the callback.
+ *  @return `GLFW_TRUE` if all contents were received, or `GLFW_FALSE` if the
+ *  transfer was cancelled or an [error](@ref error_handling) occurred.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED, @ref
+ *  GLFW_FORMAT_UNAVAILABLE and @ref GLFW_PLATFORM_ERROR.
+ *
+ *  @remark @x11 The MIME type is used as the selection target.  UTF-8 text is
+ *  also available as the `UTF8_STRING` target.  While the application itself
+ *  owns the clipboard, `UTF8_STRING`, `text/plain` and
+ *  `text/plain;charset=utf-8` are treated as the same type.  Large contents are
+ *  received with the INCR protocol, one chunk per increment.
+ *
+ *  @remark @wayland @win32 @macos Streaming clipboard retrieval is not yet
+ *  implemented on these platforms and this function emits @ref
+ *  GLFW_PLATFORM_ERROR.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref clipboard_stream
+ *  @sa @ref glfwGetClipboardString
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup input
+ */
+GLFWAPI int glfwGetClipboardDataStream(const char* mime, GLFWclipboarddatafun callback, void* user);
+
+/*! @brief Offers data of the specified MIME type on the clipboard.
+ *
+ *  This function makes the application the owner of the system clipboard and
+ *  offers data of the specified MIME type and size on it.  The data is not
+ *  copied.  Instead, the specified callback is called to retrieve it, one part
+ *  at a time, whenever another application pastes it.
+ *
+ *  The callback is called with a `NULL` buffer once the data is no longer
+ *  needed, either because the clipboard contents were replaced or because
+ *  another application took ownership of the clipboard.
+ *
+ *  @param[in] mime The MIME type of the data.
+ *  @param[in] size The size, in bytes, of the data.
+ *  @param[in] callback The function to call to retrieve the data.
+ *  @param[in] user An arbitrary pointer passed to the callback.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED and @ref
+ *  GLFW_PLATFORM_ERROR.
+ *
+ *  @remark @x11 The MIME type is used as the selection target.  Data larger
+ *  than the maximum request size of the server is sent with the INCR protocol,
+ *  one part per increment, as the receiving application asks for it.
+ *
+ *  @remark @wayland @win32 @macos Clipboard data sources are not yet
+ *  implemented on these platforms and this function emits @ref
+ *  GLFW_PLATFORM_ERROR.
+ *
+ *  @pointer_lifetime The specified MIME type is copied before this function
+ *  returns.
+ *
+ *  @thread_safety This function must only be called from the main thread.  The
+ *  callback is called from the main thread while events are processed.
+ *
+ *  @sa @ref clipboard_source
+ *  @sa @ref glfwSetClipboardString
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup input
+ */
+GLFWAPI void glfwSetClipboardDataSource(const char* mime, size_t size, GLFWclipboardsourcefun callback, void* user);
+
 /*! @brief Returns the GLFW time.
  *
  *  This function returns the current GLFW time, in seconds.  Unless the time
@@ -5439,6 +6547,36 @@ GLFWAPI uint64_t glfwGetTimerValue(void);
  */
 GLFWAPI uint64_t glfwGetTimerFrequency(void);
 
+/*! @brief Returns the raw timer value at which the current event occurred.
+ *
+ *  This function returns the value of the raw timer, as returned by @ref
+ *  glfwGetTimerValue, at which the event currently being processed was
+ *  generated.  When called from an event callback, this is the time of the
+ *  event that caused the callback.  When called elsewhere, this is the time of
+ *  the most recently processed event.
+ *
+ *  Where the platform provides a timestamp for an event, that timestamp is
+ *  translated to the raw timer.  For other events, and before any event has
+ *  been processed, this function returns the current value of the raw timer.
+ *
+ *  @return The timer value of the current event, or zero if an
+ *  [error](@ref error_handling) occurred.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED.
+ *
+ *  @remark @x11 @wayland Event timestamps have millisecond precision.
+ *
+ *  @thread_safety This function must only be called from the main thread.
+ *
+ *  @sa @ref event_time
+ *  @sa @ref glfwGetTimerValue
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup input
+ */
+GLFWAPI uint64_t glfwGetEventTime(void);
+
 /*! @brief Makes the context of the specified window current for the calling
  *  thread.
  *
@@ -5532,6 +6670,43 @@ GLFWAPI GLFWwindow* glfwGetCurrentContext(void);
  */
 GLFWAPI void glfwSwapBuffers(GLFWwindow* window);
 
+/*! @brief Retrieves the timings of frames shown by the specified window.
+ *
+ *  This function retrieves and removes the timings of the oldest frames of the
+ *  specified window that have been shown on screen since the last call, in the
+ *  order they were shown.  The timings are gathered during
+ *  [event processing](@ref events).
+ *
+ *  The window keeps the timings of the most recent @ref GLFW_FRAME_TIMINGS_SIZE
+ *  frames.  If more frames were shown since the last call, the oldest timings
+ *  are discarded.
+ *
+ *  @param[in] window The window whose frame timings to retrieve.
+ *  @param[out] timings Where to store the timings.
+ *  @param[in] max The maximum number of timings to store.
+ *  @return The number of timings stored.
+ *
+ *  @errors Possible errors include @ref GLFW_NOT_INITIALIZED and @ref
+ *  GLFW_INVALID_VALUE.
+ *
+ *  @remark @x11 Frame timings are reported via the Present extension and
+ *  require libXpresent.  Frames are reported for all presentation to the
+ *  window, including by Vulkan, but submission times are only known for
+ *  frames swapped with @ref glfwSwapBuffers.
+ *
+ *  @remark @wayland @win32 @macos Frame timings are not yet implemented on
+ *  these platforms and this function always returns zero.
+ *
+ *  @thread_safety This function may be called from any thread.
+ *
+ *  @sa @ref frame_timing
+ *
+ *  @since Added in version 3.4.
+ *
+ *  @ingroup window
+ */
+GLFWAPI int glfwGetFrameTimings(GLFWwindow* window, GLFWframetiming* timings, int max);
+
 /*! @brief Sets the swap interval for the current context.
  *
  *  This function sets the swap interval for the current OpenGL or OpenGL ES
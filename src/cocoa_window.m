@@ -207,6 +207,16 @@ static NSUInteger translateKeyToModifierFlag(int key)
     return 0;
 }
 
+// Notifies shared code of the time at which the specified event occurred
+// NOTE: Event timestamps are in seconds since system startup, which is the
+//       same time base as mach_absolute_time
+//
+static void inputEventTime(NSEvent* event)
+{
+    _glfwInputEventTime((uint64_t) ([event timestamp] *
+                                    _glfwPlatformGetTimerFrequency()));
+}
+
 // Defines a constant for empty ranges in NSTextInputClient
 //
 static const NSRange kEmptyRange = { NSNotFound, 0 };
@@ -1387,6 +1397,22 @@ void _glfwPlatformSetWindowOpacity(_GLFWwindow* window, float opacity)
     } // autoreleasepool
 }
 
+unsigned char* _glfwPlatformGetWindowPixelBuffer(_GLFWwindow* window,
+                                                 int* width, int* height,
+                                                 int* stride)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Cocoa: Pixel buffers are not supported");
+    return NULL;
+}
+
+void _glfwPlatformPresentPixelBuffer(_GLFWwindow* window,
+                                     const int* rects, int count)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Cocoa: Pixel buffers are not supported");
+}
+
 void _glfwPlatformSetRawMouseMotion(_GLFWwindow *window, GLFWbool enabled)
 {
 }
@@ -1412,6 +1438,7 @@ void _glfwPlatformPollEvents(void)
         if (event == nil)
             break;
 
+        inputEventTime(event);
         [NSApp sendEvent:event];
     }
 
@@ -1432,6 +1459,7 @@ void _glfwPlatformWaitEvents(void)
                                         untilDate:[NSDate distantFuture]
                                            inMode:NSDefaultRunLoopMode
                                           dequeue:YES];
+    inputEventTime(event);
     [NSApp sendEvent:event];
 
     _glfwPlatformPollEvents();
@@ -1452,13 +1480,27 @@ void _glfwPlatformWaitEventsTimeout(double timeout)
                                            inMode:NSDefaultRunLoopMode
                                           dequeue:YES];
     if (event)
+    {
+        inputEventTime(event);
         [NSApp sendEvent:event];
+    }
 
     _glfwPlatformPollEvents();
 
     } // autoreleasepool
 }
 
+void _glfwPlatformWaitEventsUntil(uint64_t deadline)
+{
+    const uint64_t now = _glfwPlatformGetTimerValue();
+    double timeout = 0.0;
+
+    if (deadline > now)
+        timeout = (deadline - now) / (double) _glfwPlatformGetTimerFrequency();
+
+    _glfwPlatformWaitEventsTimeout(timeout);
+}
+
 void _glfwPlatformPostEmptyEvent(void)
 {
     @autoreleasepool {
@@ -1480,6 +1522,17 @@ void _glfwPlatformPostEmptyEvent(void)
     } // autoreleasepool
 }
 
+GLFWbool _glfwPlatformAddWaitFd(int fd)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Cocoa: Waiting on file descriptors is not supported");
+    return GLFW_FALSE;
+}
+
+void _glfwPlatformRemoveWaitFd(int fd)
+{
+}
+
 void _glfwPlatformGetCursorPos(_GLFWwindow* window, double* xpos, double* ypos)
 {
     @autoreleasepool {
@@ -1496,6 +1549,11 @@ void _glfwPlatformGetCursorPos(_GLFWwindow* window, double* xpos, double* ypos)
     } // autoreleasepool
 }
 
+void _glfwPlatformQueryCursorPos(_GLFWwindow* window, double* xpos, double* ypos)
+{
+    _glfwPlatformGetCursorPos(window, xpos, ypos);
+}
+
 void _glfwPlatformSetCursorPos(_GLFWwindow* window, double x, double y)
 {
     @autoreleasepool {
@@ -1722,6 +1780,31 @@ const char* _glfwPlatformGetClipboardString(void)
     } // autoreleasepool
 }
 
+void _glfwPlatformRequestClipboardString(GLFWclipboardstringfun callback,
+                                         void* user)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Cocoa: Asynchronous clipboard requests are not supported");
+}
+
+GLFWbool _glfwPlatformGetClipboardDataStream(const char* mime,
+                                             GLFWclipboarddatafun callback,
+                                             void* user)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Cocoa: Streaming clipboard retrieval is not supported");
+    return GLFW_FALSE;
+}
+
+void _glfwPlatformSetClipboardDataSource(const char* mime,
+                                         size_t size,
+                                         GLFWclipboardsourcefun callback,
+                                         void* user)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Cocoa: Clipboard data sources are not supported");
+}
+
 void _glfwPlatformGetRequiredInstanceExtensions(char** extensions)
 {
     if (_glfw.vk.KHR_surface && _glfw.vk.EXT_metal_surface)
@@ -650,9 +650,61 @@ GLFWAPI void glfwSwapBuffers(GLFWwindow* handle)
         return;
     }
 
+    _glfwPlatformLockMutex(&_glfw.frameTimingLock);
+
+    if (window->frameTimings.submitCount == GLFW_FRAME_TIMINGS_SIZE)
+    {
+        window->frameTimings.submitHead =
+            (window->frameTimings.submitHead + 1) % GLFW_FRAME_TIMINGS_SIZE;
+        window->frameTimings.submitCount--;
+    }
+
+    window->frameTimings.submits[(window->frameTimings.submitHead +
+                                  window->frameTimings.submitCount) %
+                                 GLFW_FRAME_TIMINGS_SIZE] =
+        _glfwPlatformGetTimerValue();
+    window->frameTimings.submitCount++;
+
+    _glfwPlatformUnlockMutex(&_glfw.frameTimingLock);
+
     window->context.swapBuffers(window);
 }
 
+GLFWAPI int glfwGetFrameTimings(GLFWwindow* handle,
+                                GLFWframetiming* timings, int max)
+{
+    int i, count;
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+    assert(window != NULL);
+    assert(timings != NULL);
+
+    _GLFW_REQUIRE_INIT_OR_RETURN(0);
+
+    if (max < 0)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE, "Invalid timing count %i", max);
+        return 0;
+    }
+
+    _glfwPlatformLockMutex(&_glfw.frameTimingLock);
+
+    count = window->frameTimings.count;
+    if (count > max)
+        count = max;
+
+    for (i = 0;  i < count;  i++)
+    {
+        timings[i] = window->frameTimings.timings[window->frameTimings.head];
+        window->frameTimings.head =
+            (window->frameTimings.head + 1) % GLFW_FRAME_TIMINGS_SIZE;
+    }
+
+    window->frameTimings.count -= count;
+
+    _glfwPlatformUnlockMutex(&_glfw.frameTimingLock);
+    return count;
+}
+
 GLFWAPI void glfwSwapInterval(int interval)
 {
     _GLFWwindow* window;
@@ -667,6 +719,7 @@ GLFWAPI void glfwSwapInterval(int interval)
         return;
     }
 
+    window->context.interval = interval;
     window->context.swapInterval(interval);
 }
 
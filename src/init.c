@@ -54,6 +54,9 @@ static _GLFWinitconfig _glfwInitHints =
     {
         GLFW_TRUE,  // macOS menu bar
         GLFW_TRUE   // macOS bundle chdir
+    },
+    {
+        GLFW_FALSE  // X11 event thread
     }
 };
 
@@ -65,6 +68,11 @@ static void terminate(void)
 
     memset(&_glfw.callbacks, 0, sizeof(_glfw.callbacks));
 
+    if (_glfw.recorder.file)
+        glfwStopInputRecording();
+    if (_glfw.player.file)
+        glfwStopInputReplay();
+
     while (_glfw.windowListHead)
         glfwDestroyWindow((GLFWwindow*) _glfw.windowListHead);
 
@@ -102,6 +110,13 @@ static void terminate(void)
     _glfwPlatformDestroyTls(&_glfw.contextSlot);
     _glfwPlatformDestroyTls(&_glfw.errorSlot);
     _glfwPlatformDestroyMutex(&_glfw.errorLock);
+    _glfwPlatformDestroyMutex(&_glfw.frameTimingLock);
+
+    free(_glfw.userEvents.pending);
+    free(_glfw.userEvents.spare);
+    _glfwPlatformDestroyMutex(&_glfw.userEvents.lock);
+
+    free(_glfw.waitFds.entries);
 
     memset(&_glfw, 0, sizeof(_glfw));
 }
@@ -234,6 +249,8 @@ GLFWAPI int glfwInit(void)
     }
 
     if (!_glfwPlatformCreateMutex(&_glfw.errorLock) ||
+        !_glfwPlatformCreateMutex(&_glfw.frameTimingLock) ||
+        !_glfwPlatformCreateMutex(&_glfw.userEvents.lock) ||
         !_glfwPlatformCreateTls(&_glfw.errorSlot) ||
         !_glfwPlatformCreateTls(&_glfw.contextSlot))
     {
@@ -273,6 +290,9 @@ GLFWAPI void glfwInitHint(int hint, int value)
         case GLFW_COCOA_MENUBAR:
             _glfwInitHints.ns.menubar = value;
             return;
+        case GLFW_X11_EVENT_THREAD:
+            _glfwInitHints.x11.eventThread = value;
+            return;
     }
 
     _glfwInputError(GLFW_INVALID_ENUM,
@@ -32,6 +32,7 @@
 
 #include <assert.h>
 #include <float.h>
+#include <limits.h>
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
@@ -241,6 +242,85 @@ static GLFWbool parseMapping(_GLFWmapping* mapping, const char* string)
 }
 
 
+// Increments a transition counter unless it has saturated
+//
+static void countTransition(_GLFWwindow* window, unsigned char* counter)
+{
+    if (*counter < UCHAR_MAX)
+        (*counter)++;
+
+    window->transitions.counted = GLFW_TRUE;
+}
+
+// Updates the packed state of a key to match its unpacked state
+//
+static void updateKeyBit(_GLFWwindow* window, int key)
+{
+    const uint64_t bit = (uint64_t) 1 << (key % 64);
+
+    if (window->keys[key] == GLFW_RELEASE)
+        window->packed.keys[key / 64] &= ~bit;
+    else
+        window->packed.keys[key / 64] |= bit;
+}
+
+// Updates the packed state of a mouse button to match its unpacked state
+//
+static void updateMouseButtonBit(_GLFWwindow* window, int button)
+{
+    const unsigned int bit = 1u << button;
+
+    if (window->mouseButtons[button] == GLFW_RELEASE)
+        window->packed.mouseButtons &= ~bit;
+    else
+        window->packed.mouseButtons |= bit;
+}
+
+// Appends a cursor position to the cursor history of a window, discarding the
+// oldest sample if the history is full
+//
+static void appendCursorSample(_GLFWwindow* window, double xpos, double ypos)
+{
+    GLFWcursorsample* sample;
+
+    if (window->cursorHistory.count == GLFW_CURSOR_HISTORY_SIZE)
+    {
+        window->cursorHistory.head =
+            (window->cursorHistory.head + 1) % GLFW_CURSOR_HISTORY_SIZE;
+        window->cursorHistory.count--;
+    }
+
+    sample = window->cursorHistory.samples +
+        (window->cursorHistory.head + window->cursorHistory.count) %
+        GLFW_CURSOR_HISTORY_SIZE;
+    window->cursorHistory.count++;
+
+    sample->x = xpos;
+    sample->y = ypos;
+    sample->time = _glfw.timer.event;
+    if (!sample->time)
+        sample->time = _glfwPlatformGetTimerValue();
+}
+
+// Passes a cursor position to the event queue and callback of a window
+//
+static void cursorPosEvent(_GLFWwindow* window, double xpos, double ypos)
+{
+    if (_glfw.recorder.file)
+        _glfwRecordCursorPos(window, xpos, ypos);
+
+    if (window->queue.events)
+    {
+        GLFWevent* event = _glfwQueueEvent(window, GLFW_EVENT_CURSOR_POS);
+        event->data.cursorPos.x = xpos;
+        event->data.cursorPos.y = ypos;
+    }
+
+    if (window->callbacks.cursorPos)
+        window->callbacks.cursorPos((GLFWwindow*) window, xpos, ypos);
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 //////                         GLFW event API                       //////
 //////////////////////////////////////////////////////////////////////////
@@ -249,6 +329,11 @@ static GLFWbool parseMapping(_GLFWmapping* mapping, const char* string)
 //
 void _glfwInputKey(_GLFWwindow* window, int key, int scancode, int action, int mods)
 {
+    if (_glfw.recorder.file)
+        _glfwRecordKey(window, key, scancode, action, mods);
+
+    _glfwFlushCoalescedEvents(window);
+
     if (key >= 0 && key <= GLFW_KEY_LAST)
     {
         GLFWbool repeated = GLFW_FALSE;
@@ -264,6 +349,13 @@ void _glfwInputKey(_GLFWwindow* window, int key, int scancode, int action, int m
         else
             window->keys[key] = (char) action;
 
+        updateKeyBit(window, key);
+
+        if (action == GLFW_PRESS && !repeated)
+            countTransition(window, window->transitions.keyPresses + key);
+        else if (action == GLFW_RELEASE)
+            countTransition(window, window->transitions.keyReleases + key);
+
         if (repeated)
             action = GLFW_REPEAT;
     }
@@ -271,6 +363,15 @@ void _glfwInputKey(_GLFWwindow* window, int key, int scancode, int action, int m
     if (!window->lockKeyMods)
         mods &= ~(GLFW_MOD_CAPS_LOCK | GLFW_MOD_NUM_LOCK);
 
+    if (window->queue.events)
+    {
+        GLFWevent* event = _glfwQueueEvent(window, GLFW_EVENT_KEY);
+        event->data.key.key = key;
+        event->data.key.scancode = scancode;
+        event->data.key.action = action;
+        event->data.key.mods = mods;
+    }
+
     if (window->callbacks.key)
         window->callbacks.key((GLFWwindow*) window, key, scancode, action, mods);
 }
@@ -280,6 +381,11 @@ void _glfwInputKey(_GLFWwindow* window, int key, int scancode, int action, int m
 //
 void _glfwInputChar(_GLFWwindow* window, unsigned int codepoint, int mods, GLFWbool plain)
 {
+    if (_glfw.recorder.file)
+        _glfwRecordChar(window, codepoint, mods, plain);
+
+    _glfwFlushCoalescedEvents(window);
+
     if (codepoint < 32 || (codepoint > 126 && codepoint < 160))
         return;
 
@@ -291,6 +397,12 @@ void _glfwInputChar(_GLFWwindow* window, unsigned int codepoint, int mods, GLFWb
 
     if (plain)
     {
+        if (window->queue.events)
+        {
+            GLFWevent* event = _glfwQueueEvent(window, GLFW_EVENT_CHAR);
+            event->data.character.codepoint = codepoint;
+        }
+
         if (window->callbacks.character)
             window->callbacks.character((GLFWwindow*) window, codepoint);
     }
@@ -300,6 +412,25 @@ void _glfwInputChar(_GLFWwindow* window, unsigned int codepoint, int mods, GLFWb
 //
 void _glfwInputScroll(_GLFWwindow* window, double xoffset, double yoffset)
 {
+    if (window->coalesceEvents)
+    {
+        window->pending.scroll = GLFW_TRUE;
+        window->pending.xoffset += xoffset;
+        window->pending.yoffset += yoffset;
+        window->pending.scrollTime = _glfw.timer.event;
+        return;
+    }
+
+    if (_glfw.recorder.file)
+        _glfwRecordScroll(window, xoffset, yoffset);
+
+    if (window->queue.events)
+    {
+        GLFWevent* event = _glfwQueueEvent(window, GLFW_EVENT_SCROLL);
+        event->data.scroll.x = xoffset;
+        event->data.scroll.y = yoffset;
+    }
+
     if (window->callbacks.scroll)
         window->callbacks.scroll((GLFWwindow*) window, xoffset, yoffset);
 }
@@ -308,6 +439,11 @@ void _glfwInputScroll(_GLFWwindow* window, double xoffset, double yoffset)
 //
 void _glfwInputMouseClick(_GLFWwindow* window, int button, int action, int mods)
 {
+    if (_glfw.recorder.file)
+        _glfwRecordMouseClick(window, button, action, mods);
+
+    _glfwFlushCoalescedEvents(window);
+
     if (button < 0 || button > GLFW_MOUSE_BUTTON_LAST)
         return;
 
@@ -319,6 +455,21 @@ void _glfwInputMouseClick(_GLFWwindow* window, int button, int action, int mods)
     else
         window->mouseButtons[button] = (char) action;
 
+    updateMouseButtonBit(window, button);
+
+    if (action == GLFW_PRESS)
+        countTransition(window, window->transitions.mouseButtonPresses + button);
+    else if (action == GLFW_RELEASE)
+        countTransition(window, window->transitions.mouseButtonReleases + button);
+
+    if (window->queue.events)
+    {
+        GLFWevent* event = _glfwQueueEvent(window, GLFW_EVENT_MOUSE_BUTTON);
+        event->data.mouseButton.button = button;
+        event->data.mouseButton.action = action;
+        event->data.mouseButton.mods = mods;
+    }
+
     if (window->callbacks.mouseButton)
         window->callbacks.mouseButton((GLFWwindow*) window, button, action, mods);
 }
@@ -331,17 +482,36 @@ void _glfwInputCursorPos(_GLFWwindow* window, double xpos, double ypos)
     if (window->virtualCursorPosX == xpos && window->virtualCursorPosY == ypos)
         return;
 
+    appendCursorSample(window, xpos, ypos);
+
     window->virtualCursorPosX = xpos;
     window->virtualCursorPosY = ypos;
 
-    if (window->callbacks.cursorPos)
-        window->callbacks.cursorPos((GLFWwindow*) window, xpos, ypos);
+    if (window->coalesceEvents)
+    {
+        window->pending.cursorPos = GLFW_TRUE;
+        window->pending.cursorPosTime = _glfw.timer.event;
+        return;
+    }
+
+    cursorPosEvent(window, xpos, ypos);
 }
 
 // Notifies shared code of a cursor enter/leave event
 //
 void _glfwInputCursorEnter(_GLFWwindow* window, GLFWbool entered)
 {
+    if (_glfw.recorder.file)
+        _glfwRecordCursorEnter(window, entered);
+
+    _glfwFlushCoalescedEvents(window);
+
+    if (window->queue.events)
+    {
+        GLFWevent* event = _glfwQueueEvent(window, GLFW_EVENT_CURSOR_ENTER);
+        event->data.cursorEnter.entered = entered;
+    }
+
     if (window->callbacks.cursorEnter)
         window->callbacks.cursorEnter((GLFWwindow*) window, entered);
 }
@@ -350,6 +520,8 @@ void _glfwInputCursorEnter(_GLFWwindow* window, GLFWbool entered)
 //
 void _glfwInputDrop(_GLFWwindow* window, int count, const char** paths)
 {
+    _glfwFlushCoalescedEvents(window);
+
     if (window->callbacks.drop)
         window->callbacks.drop((GLFWwindow*) window, count, paths);
 }
@@ -368,6 +540,9 @@ void _glfwInputJoystick(_GLFWjoystick* js, int event)
 //
 void _glfwInputJoystickAxis(_GLFWjoystick* js, int axis, float value)
 {
+    if (_glfw.recorder.file)
+        _glfwRecordJoystickAxis(js, axis, value);
+
     js->axes[axis] = value;
 }
 
@@ -375,6 +550,9 @@ void _glfwInputJoystickAxis(_GLFWjoystick* js, int axis, float value)
 //
 void _glfwInputJoystickButton(_GLFWjoystick* js, int button, char value)
 {
+    if (_glfw.recorder.file)
+        _glfwRecordJoystickButton(js, button, value);
+
     js->buttons[button] = value;
 }
 
@@ -384,6 +562,9 @@ void _glfwInputJoystickHat(_GLFWjoystick* js, int hat, char value)
 {
     const int base = js->buttonCount + hat * 4;
 
+    if (_glfw.recorder.file)
+        _glfwRecordJoystickHat(js, hat, value);
+
     js->buttons[base + 0] = (value & 0x01) ? GLFW_PRESS : GLFW_RELEASE;
     js->buttons[base + 1] = (value & 0x02) ? GLFW_PRESS : GLFW_RELEASE;
     js->buttons[base + 2] = (value & 0x04) ? GLFW_PRESS : GLFW_RELEASE;
@@ -392,6 +573,14 @@ void _glfwInputJoystickHat(_GLFWjoystick* js, int hat, char value)
     js->hats[hat] = value;
 }
 
+// Notifies shared code of the timer value at which the event being processed
+// was generated, or zero if the platform did not provide one
+//
+void _glfwInputEventTime(uint64_t time)
+{
+    _glfw.timer.event = time;
+}
+
 
 //////////////////////////////////////////////////////////////////////////
 //////                       GLFW internal API                      //////
@@ -476,6 +665,134 @@ void _glfwCenterCursorInContentArea(_GLFWwindow* window)
     _glfwPlatformSetCursorPos(window, width / 2.0, height / 2.0);
 }
 
+// Translates a millisecond event timestamp with an unknown epoch, as provided
+// by X11 and Wayland, to the timer value at which the event was generated
+//
+uint64_t _glfwTranslateEventTime(uint32_t milliseconds)
+{
+    const uint64_t now = _glfwPlatformGetTimerValue();
+    const uint64_t frequency = _glfwPlatformGetTimerFrequency();
+    const uint32_t current = (uint32_t) ((now / frequency) * 1000 +
+                                         (now % frequency) * 1000 / frequency);
+    const uint32_t base = current - milliseconds;
+    uint64_t age;
+
+    // The offset with the smallest observed latency is the best estimate of
+    // the true offset between the two clocks, as no event can be older than
+    // the moment it was received
+    // NOTE: The 32-bit timestamps wrap around, so comparisons are made on the
+    //       signed difference
+    if (!_glfw.timer.eventBaseValid ||
+        (int32_t) (base - _glfw.timer.eventBase) < 0)
+    {
+        _glfw.timer.eventBase = base;
+        _glfw.timer.eventBaseValid = GLFW_TRUE;
+    }
+
+    age = (uint64_t) (base - _glfw.timer.eventBase) * frequency / 1000;
+    if (age > now)
+        return now;
+
+    return now - age;
+}
+
+// Appends an event of the specified type to the event queue of the window and
+// returns it so its type-specific data can be filled in
+//
+GLFWevent* _glfwQueueEvent(_GLFWwindow* window, int type)
+{
+    GLFWevent* event;
+
+    // Discard the oldest event if the queue is full
+    if (window->queue.count == _GLFW_EVENT_QUEUE_SIZE)
+    {
+        window->queue.head = (window->queue.head + 1) % _GLFW_EVENT_QUEUE_SIZE;
+        window->queue.count--;
+    }
+
+    event = window->queue.events +
+        (window->queue.head + window->queue.count) % _GLFW_EVENT_QUEUE_SIZE;
+    window->queue.count++;
+
+    memset(event, 0, sizeof(GLFWevent));
+    event->type = type;
+    event->time = _glfw.timer.event;
+    if (!event->time)
+        event->time = _glfwPlatformGetTimerValue();
+
+    return event;
+}
+
+// Passes on the coalesced events held for the specified window
+//
+void _glfwFlushCoalescedEvents(_GLFWwindow* window)
+{
+    const uint64_t time = _glfw.timer.event;
+    const GLFWbool coalesce = window->coalesceEvents;
+
+    if (!window->pending.pos &&
+        !window->pending.size &&
+        !window->pending.fbsize &&
+        !window->pending.cursorPos &&
+        !window->pending.scroll)
+    {
+        return;
+    }
+
+    // Coalescing is suspended while the held events are passed on so that
+    // they are not held again
+    window->coalesceEvents = GLFW_FALSE;
+
+    if (window->pending.pos)
+    {
+        window->pending.pos = GLFW_FALSE;
+        _glfwInputEventTime(window->pending.posTime);
+        _glfwInputWindowPos(window, window->pending.xpos, window->pending.ypos);
+    }
+
+    if (window->pending.size)
+    {
+        window->pending.size = GLFW_FALSE;
+        _glfwInputEventTime(window->pending.sizeTime);
+        _glfwInputWindowSize(window,
+                             window->pending.width,
+                             window->pending.height);
+    }
+
+    if (window->pending.fbsize)
+    {
+        window->pending.fbsize = GLFW_FALSE;
+        _glfwInputEventTime(window->pending.fbsizeTime);
+        _glfwInputFramebufferSize(window,
+                                  window->pending.fbwidth,
+                                  window->pending.fbheight);
+    }
+
+    if (window->pending.cursorPos)
+    {
+        window->pending.cursorPos = GLFW_FALSE;
+        _glfwInputEventTime(window->pending.cursorPosTime);
+        cursorPosEvent(window,
+                       window->virtualCursorPosX,
+                       window->virtualCursorPosY);
+    }
+
+    if (window->pending.scroll)
+    {
+        const double xoffset = window->pending.xoffset;
+        const double yoffset = window->pending.yoffset;
+
+        window->pending.scroll = GLFW_FALSE;
+        window->pending.xoffset = 0.0;
+        window->pending.yoffset = 0.0;
+        _glfwInputEventTime(window->pending.scrollTime);
+        _glfwInputScroll(window, xoffset, yoffset);
+    }
+
+    window->coalesceEvents = coalesce;
+    _glfwInputEventTime(time);
+}
+
 
 //////////////////////////////////////////////////////////////////////////
 //////                        GLFW public API                       //////
@@ -500,6 +817,8 @@ GLFWAPI int glfwGetInputMode(GLFWwindow* handle, int mode)
             return window->lockKeyMods;
         case GLFW_RAW_MOUSE_MOTION:
             return window->rawMouseMotion;
+        case GLFW_EVENT_QUEUE:
+            return window->queue.events != NULL;
     }
 
     _glfwInputError(GLFW_INVALID_ENUM, "Invalid input mode 0x%08X", mode);
@@ -549,7 +868,10 @@ GLFWAPI void glfwSetInputMode(GLFWwindow* handle, int mode, int value)
             for (i = 0;  i <= GLFW_KEY_LAST;  i++)
             {
                 if (window->keys[i] == _GLFW_STICK)
+                {
                     window->keys[i] = GLFW_RELEASE;
+                    updateKeyBit(window, i);
+                }
             }
         }
 
@@ -569,7 +891,10 @@ GLFWAPI void glfwSetInputMode(GLFWwindow* handle, int mode, int value)
             for (i = 0;  i <= GLFW_MOUSE_BUTTON_LAST;  i++)
             {
                 if (window->mouseButtons[i] == _GLFW_STICK)
+                {
                     window->mouseButtons[i] = GLFW_RELEASE;
+                    updateMouseButtonBit(window, i);
+                }
             }
         }
 
@@ -595,6 +920,22 @@ GLFWAPI void glfwSetInputMode(GLFWwindow* handle, int mode, int value)
         window->rawMouseMotion = value;
         _glfwPlatformSetRawMouseMotion(window, value);
     }
+    else if (mode == GLFW_EVENT_QUEUE)
+    {
+        if (value)
+        {
+            if (!window->queue.events)
+            {
+                window->queue.events =
+                    calloc(_GLFW_EVENT_QUEUE_SIZE, sizeof(GLFWevent));
+            }
+        }
+        else
+        {
+            free(window->queue.events);
+            memset(&window->queue, 0, sizeof(window->queue));
+        }
+    }
     else
         _glfwInputError(GLFW_INVALID_ENUM, "Invalid input mode 0x%08X", mode);
 }
@@ -654,6 +995,7 @@ GLFWAPI int glfwGetKey(GLFWwindow* handle, int key)
     {
         // Sticky mode: release key now
         window->keys[key] = GLFW_RELEASE;
+        updateKeyBit(window, key);
         return GLFW_PRESS;
     }
 
@@ -677,12 +1019,131 @@ GLFWAPI int glfwGetMouseButton(GLFWwindow* handle, int button)
     {
         // Sticky mode: release mouse button now
         window->mouseButtons[button] = GLFW_RELEASE;
+        updateMouseButtonBit(window, button);
         return GLFW_PRESS;
     }
 
     return (int) window->mouseButtons[button];
 }
 
+GLFWAPI void glfwGetKeyboardState(GLFWwindow* handle,
+                                  uint64_t* state, uint64_t* changed)
+{
+    int i;
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+    assert(window != NULL);
+    assert(state != NULL);
+
+    _GLFW_REQUIRE_INIT();
+
+    for (i = 0;  i < GLFW_KEYBOARD_STATE_WORDS;  i++)
+        state[i] = window->packed.keys[i];
+
+    if (changed)
+    {
+        for (i = 0;  i < GLFW_KEYBOARD_STATE_WORDS;  i++)
+            changed[i] = window->packed.keys[i] ^ window->packed.previousKeys[i];
+    }
+
+    if (window->stickyKeys)
+    {
+        // Sticky mode: release all reported keys now
+        for (i = 0;  i <= GLFW_KEY_LAST;  i++)
+        {
+            if (window->keys[i] == _GLFW_STICK)
+            {
+                window->keys[i] = GLFW_RELEASE;
+                updateKeyBit(window, i);
+            }
+        }
+    }
+}
+
+GLFWAPI void glfwGetMouseState(GLFWwindow* handle,
+                               unsigned int* state, unsigned int* changed)
+{
+    int i;
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+    assert(window != NULL);
+    assert(state != NULL);
+
+    _GLFW_REQUIRE_INIT();
+
+    *state = window->packed.mouseButtons;
+
+    if (changed)
+    {
+        *changed = window->packed.mouseButtons ^
+                   window->packed.previousMouseButtons;
+    }
+
+    if (window->stickyMouseButtons)
+    {
+        // Sticky mode: release all reported mouse buttons now
+        for (i = 0;  i <= GLFW_MOUSE_BUTTON_LAST;  i++)
+        {
+            if (window->mouseButtons[i] == _GLFW_STICK)
+            {
+                window->mouseButtons[i] = GLFW_RELEASE;
+                updateMouseButtonBit(window, i);
+            }
+        }
+    }
+}
+
+GLFWAPI void glfwGetKeyTransitions(GLFWwindow* handle,
+                                   const int* keys, int count,
+                                   int* presses, int* releases)
+{
+    int i;
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+    assert(window != NULL);
+    assert(keys != NULL || count == 0);
+    assert(count >= 0);
+
+    _GLFW_REQUIRE_INIT();
+
+    for (i = 0;  i < count;  i++)
+    {
+        const int key = keys[i];
+
+        if (key < GLFW_KEY_SPACE || key > GLFW_KEY_LAST)
+        {
+            _glfwInputError(GLFW_INVALID_ENUM, "Invalid key %i", key);
+
+            if (presses)
+                presses[i] = 0;
+            if (releases)
+                releases[i] = 0;
+
+            continue;
+        }
+
+        if (presses)
+            presses[i] = window->transitions.keyPresses[key];
+        if (releases)
+            releases[i] = window->transitions.keyReleases[key];
+    }
+}
+
+GLFWAPI void glfwGetMouseButtonTransitions(GLFWwindow* handle,
+                                           int* presses, int* releases)
+{
+    int i;
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+    assert(window != NULL);
+
+    _GLFW_REQUIRE_INIT();
+
+    for (i = 0;  i <= GLFW_MOUSE_BUTTON_LAST;  i++)
+    {
+        if (presses)
+            presses[i] = window->transitions.mouseButtonPresses[i];
+        if (releases)
+            releases[i] = window->transitions.mouseButtonReleases[i];
+    }
+}
+
 GLFWAPI void glfwGetCursorPos(GLFWwindow* handle, double* xpos, double* ypos)
 {
     _GLFWwindow* window = (_GLFWwindow*) handle;
@@ -706,6 +1167,70 @@ GLFWAPI void glfwGetCursorPos(GLFWwindow* handle, double* xpos, double* ypos)
         _glfwPlatformGetCursorPos(window, xpos, ypos);
 }
 
+GLFWAPI void glfwQueryCursorPosExact(GLFWwindow* handle, double* xpos, double* ypos)
+{
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+    assert(window != NULL);
+
+    if (xpos)
+        *xpos = 0;
+    if (ypos)
+        *ypos = 0;
+
+    _GLFW_REQUIRE_INIT();
+
+    if (window->cursorMode == GLFW_CURSOR_DISABLED)
+    {
+        if (xpos)
+            *xpos = window->virtualCursorPosX;
+        if (ypos)
+            *ypos = window->virtualCursorPosY;
+    }
+    else
+        _glfwPlatformQueryCursorPos(window, xpos, ypos);
+}
+
+GLFWAPI int glfwGetCursorHistory(GLFWwindow* handle,
+                                 GLFWcursorsample* samples,
+                                 int max)
+{
+    int count, start, first;
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+    assert(window != NULL);
+    assert(samples != NULL);
+
+    _GLFW_REQUIRE_INIT_OR_RETURN(0);
+
+    if (max < 0)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE, "Invalid sample count %i", max);
+        return 0;
+    }
+
+    count = window->cursorHistory.count;
+    if (count > max)
+        count = max;
+    if (!count)
+        return 0;
+
+    // Skip the oldest samples that do not fit, which may wrap around the end of
+    // the ring buffer
+    start = (window->cursorHistory.head + window->cursorHistory.count - count) %
+        GLFW_CURSOR_HISTORY_SIZE;
+    first = GLFW_CURSOR_HISTORY_SIZE - start;
+    if (first > count)
+        first = count;
+
+    memcpy(samples,
+           window->cursorHistory.samples + start,
+           first * sizeof(GLFWcursorsample));
+    memcpy(samples + first,
+           window->cursorHistory.samples,
+           (count - first) * sizeof(GLFWcursorsample));
+
+    return count;
+}
+
 GLFWAPI void glfwSetCursorPos(GLFWwindow* handle, double xpos, double ypos)
 {
     _GLFWwindow* window = (_GLFWwindow*) handle;
@@ -921,6 +1446,45 @@ GLFWAPI GLFWdropfun glfwSetDropCallback(GLFWwindow* handle, GLFWdropfun cbfun)
     return cbfun;
 }
 
+GLFWAPI int glfwGetEvents(GLFWwindow* handle, GLFWevent* events, int capacity)
+{
+    int count, first;
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+    assert(window != NULL);
+    assert(events != NULL);
+
+    _GLFW_REQUIRE_INIT_OR_RETURN(0);
+
+    if (capacity < 0)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE, "Invalid event capacity %i", capacity);
+        return 0;
+    }
+
+    count = window->queue.count;
+    if (count > capacity)
+        count = capacity;
+    if (!count)
+        return 0;
+
+    // The events may wrap around the end of the ring buffer
+    first = _GLFW_EVENT_QUEUE_SIZE - window->queue.head;
+    if (first > count)
+        first = count;
+
+    memcpy(events,
+           window->queue.events + window->queue.head,
+           first * sizeof(GLFWevent));
+    memcpy(events + first,
+           window->queue.events,
+           (count - first) * sizeof(GLFWevent));
+
+    window->queue.head = (window->queue.head + count) % _GLFW_EVENT_QUEUE_SIZE;
+    window->queue.count -= count;
+
+    return count;
+}
+
 GLFWAPI int glfwJoystickPresent(int jid)
 {
     _GLFWjoystick* js;
@@ -1333,6 +1897,38 @@ GLFWAPI const char* glfwGetClipboardString(GLFWwindow* handle)
     return _glfwPlatformGetClipboardString();
 }
 
+GLFWAPI void glfwRequestClipboardString(GLFWclipboardstringfun callback,
+                                        void* user)
+{
+    assert(callback != NULL);
+
+    _GLFW_REQUIRE_INIT();
+    _glfwPlatformRequestClipboardString(callback, user);
+}
+
+GLFWAPI int glfwGetClipboardDataStream(const char* mime,
+                                       GLFWclipboarddatafun callback,
+                                       void* user)
+{
+    assert(mime != NULL);
+    assert(callback != NULL);
+
+    _GLFW_REQUIRE_INIT_OR_RETURN(GLFW_FALSE);
+    return _glfwPlatformGetClipboardDataStream(mime, callback, user);
+}
+
+GLFWAPI void glfwSetClipboardDataSource(const char* mime,
+                                        size_t size,
+                                        GLFWclipboardsourcefun callback,
+                                        void* user)
+{
+    assert(mime != NULL);
+    assert(callback != NULL);
+
+    _GLFW_REQUIRE_INIT();
+    _glfwPlatformSetClipboardDataSource(mime, size, callback, user);
+}
+
 GLFWAPI double glfwGetTime(void)
 {
     _GLFW_REQUIRE_INIT_OR_RETURN(0.0);
@@ -1360,6 +1956,16 @@ GLFWAPI uint64_t glfwGetTimerValue(void)
     return _glfwPlatformGetTimerValue();
 }
 
+GLFWAPI uint64_t glfwGetEventTime(void)
+{
+    _GLFW_REQUIRE_INIT_OR_RETURN(0);
+
+    if (_glfw.timer.event)
+        return _glfw.timer.event;
+
+    return _glfwPlatformGetTimerValue();
+}
+
 GLFWAPI uint64_t glfwGetTimerFrequency(void)
 {
     _GLFW_REQUIRE_INIT_OR_RETURN(0);
@@ -57,6 +57,7 @@
 #define _GLFW_POLL_ALL          (_GLFW_POLL_AXES | _GLFW_POLL_BUTTONS)
 
 #define _GLFW_MESSAGE_SIZE      1024
+#define _GLFW_EVENT_QUEUE_SIZE  4096
 
 typedef int GLFWbool;
 
@@ -75,6 +76,8 @@ typedef struct _GLFWmapping     _GLFWmapping;
 typedef struct _GLFWjoystick    _GLFWjoystick;
 typedef struct _GLFWtls         _GLFWtls;
 typedef struct _GLFWmutex       _GLFWmutex;
+typedef struct _GLFWuserevent   _GLFWuserevent;
+typedef struct _GLFWwaitfd      _GLFWwaitfd;
 
 typedef void (* _GLFWmakecontextcurrentfun)(_GLFWwindow*);
 typedef void (* _GLFWswapbuffersfun)(_GLFWwindow*);
@@ -233,6 +236,23 @@ struct _GLFWerror
     char            description[_GLFW_MESSAGE_SIZE];
 };
 
+// User event posted from any thread, waiting to be delivered
+//
+struct _GLFWuserevent
+{
+    _GLFWwindow*    window;
+    uint64_t        payload;
+    uint64_t        time;
+};
+
+// File descriptor added with glfwAddWaitFd
+//
+struct _GLFWwaitfd
+{
+    int             fd;
+    GLFWwaitfdfun   callback;
+};
+
 // Initialization configuration
 //
 // Parameters relating to the initialization of the library
@@ -244,6 +264,9 @@ struct _GLFWinitconfig
         GLFWbool  menubar;
         GLFWbool  chdir;
     } ns;
+    struct {
+        GLFWbool  eventThread;
+    } x11;
 };
 
 // Window configuration
@@ -267,6 +290,7 @@ struct _GLFWwndconfig
     GLFWbool      centerCursor;
     GLFWbool      focusOnShow;
     GLFWbool      scaleToMonitor;
+    GLFWbool      coalesceEvents;
     struct {
         GLFWbool  retina;
         char      frameName[256];
@@ -341,6 +365,8 @@ struct _GLFWcontext
     int                 profile;
     int                 robustness;
     int                 release;
+    // Most recently set swap interval
+    int                 interval;
 
     PFNGLGETSTRINGIPROC  GetStringi;
     PFNGLGETINTEGERVPROC GetIntegerv;
@@ -367,12 +393,17 @@ struct _GLFWwindow
 {
     struct _GLFWwindow* next;
 
+    // Creation order of the window since initialization, used to identify it
+    // in input recordings
+    int                 serial;
+
     // Window settings and state
     GLFWbool            resizable;
     GLFWbool            decorated;
     GLFWbool            autoIconify;
     GLFWbool            floating;
     GLFWbool            focusOnShow;
+    GLFWbool            coalesceEvents;
     GLFWbool            shouldClose;
     void*               userPointer;
     GLFWbool            doublebuffer;
@@ -390,10 +421,64 @@ struct _GLFWwindow
     int                 cursorMode;
     char                mouseButtons[GLFW_MOUSE_BUTTON_LAST + 1];
     char                keys[GLFW_KEY_LAST + 1];
+    // Packed copies of the above with a bit set for each pressed or stuck key
+    // or mouse button, and the same at the start of the last event processing
+    struct {
+        uint64_t        keys[GLFW_KEYBOARD_STATE_WORDS];
+        uint64_t        previousKeys[GLFW_KEYBOARD_STATE_WORDS];
+        unsigned int    mouseButtons;
+        unsigned int    previousMouseButtons;
+    } packed;
+    // Number of presses and releases of each key and mouse button since the
+    // start of the last event processing, saturating at UCHAR_MAX
+    struct {
+        GLFWbool        counted;
+        unsigned char   keyPresses[GLFW_KEY_LAST + 1];
+        unsigned char   keyReleases[GLFW_KEY_LAST + 1];
+        unsigned char   mouseButtonPresses[GLFW_MOUSE_BUTTON_LAST + 1];
+        unsigned char   mouseButtonReleases[GLFW_MOUSE_BUTTON_LAST + 1];
+    } transitions;
     // Virtual cursor position when cursor is disabled
     double              virtualCursorPosX, virtualCursorPosY;
+    // Ring buffer of cursor positions received since the start of the last
+    // event processing
+    struct {
+        GLFWcursorsample samples[GLFW_CURSOR_HISTORY_SIZE];
+        int             head;
+        int             count;
+    } cursorHistory;
+
+    // Swap times of frames not yet shown and timings of shown frames not yet
+    // retrieved, guarded by the frame timing lock
+    struct {
+        uint64_t        submits[GLFW_FRAME_TIMINGS_SIZE];
+        int             submitHead;
+        int             submitCount;
+        GLFWframetiming timings[GLFW_FRAME_TIMINGS_SIZE];
+        int             head;
+        int             count;
+    } frameTimings;
     GLFWbool            rawMouseMotion;
 
+    // Ring buffer of queued events, allocated while the event queue is enabled
+    struct {
+        GLFWevent*      events;
+        int             head;
+        int             count;
+    } queue;
+
+    // Coalesced events held until the next other event or the end of event
+    // processing, whichever comes first
+    struct {
+        GLFWbool        pos, size, fbsize, cursorPos, scroll;
+        int             xpos, ypos;
+        int             width, height;
+        int             fbwidth, fbheight;
+        double          xoffset, yoffset;
+        uint64_t        posTime, sizeTime, fbsizeTime;
+        uint64_t        cursorPosTime, scrollTime;
+    } pending;
+
     _GLFWcontext        context;
 
     struct {
@@ -414,6 +499,7 @@ struct _GLFWwindow
         GLFWcharfun               character;
         GLFWcharmodsfun           charmods;
         GLFWdropfun               drop;
+        GLFWusereventfun          user;
     } callbacks;
 
     // This is defined in the window API's platform.h
@@ -527,6 +613,7 @@ struct _GLFWlibrary
     _GLFWerror*         errorListHead;
     _GLFWcursor*        cursorListHead;
     _GLFWwindow*        windowListHead;
+    int                 windowSerial;
 
     _GLFWmonitor**      monitors;
     int                 monitorCount;
@@ -538,9 +625,60 @@ struct _GLFWlibrary
     _GLFWtls            errorSlot;
     _GLFWtls            contextSlot;
     _GLFWmutex          errorLock;
+    // Guards the frame timings of all windows, as buffers may be swapped on
+    // any thread
+    _GLFWmutex          frameTimingLock;
+
+    // User events posted but not yet delivered, guarded by lock
+    // Delivery swaps the pending and spare arrays so posting threads are only
+    // blocked for the duration of the swap
+    struct {
+        _GLFWmutex      lock;
+        _GLFWuserevent* pending;
+        int             count;
+        int             capacity;
+        _GLFWuserevent* spare;
+        int             spareCount;
+        int             spareCapacity;
+    } userEvents;
+
+    // File descriptors added with glfwAddWaitFd
+    struct {
+        _GLFWwaitfd*    entries;
+        int             count;
+    } waitFds;
+
+    // Input recording being written, if any
+    struct {
+        void*           file;
+        // Timer value at the start of the recording
+        uint64_t        base;
+        // Time of the last record, in microseconds since the start
+        int64_t         time;
+    } recorder;
+
+    // Input recording being replayed, if any
+    struct {
+        void*           file;
+        int             speed;
+        // Timer value at the start of the replay
+        uint64_t        base;
+        // The next record to be replayed and its time in microseconds since
+        // the start
+        int64_t         time;
+        int             type;
+        int             target;
+        int             ints[4];
+        double          reals[2];
+    } player;
 
     struct {
         uint64_t        offset;
+        // Timer value of the event being processed, or zero if unknown
+        uint64_t        event;
+        // Millisecond offset from platform event timestamps to the timer
+        uint32_t        eventBase;
+        GLFWbool        eventBaseValid;
         // This is defined in the platform's time.h
         _GLFW_PLATFORM_LIBRARY_TIMER_STATE;
     } timer;
@@ -598,6 +736,7 @@ void _glfwPlatformTerminate(void);
 const char* _glfwPlatformGetVersionString(void);
 
 void _glfwPlatformGetCursorPos(_GLFWwindow* window, double* xpos, double* ypos);
+void _glfwPlatformQueryCursorPos(_GLFWwindow* window, double* xpos, double* ypos);
 void _glfwPlatformSetCursorPos(_GLFWwindow* window, double xpos, double ypos);
 void _glfwPlatformSetCursorMode(_GLFWwindow* window, int mode);
 void _glfwPlatformSetRawMouseMotion(_GLFWwindow *window, GLFWbool enabled);
@@ -623,6 +762,15 @@ void _glfwPlatformSetGammaRamp(_GLFWmonitor* monitor, const GLFWgammaramp* ramp)
 
 void _glfwPlatformSetClipboardString(const char* string);
 const char* _glfwPlatformGetClipboardString(void);
+void _glfwPlatformRequestClipboardString(GLFWclipboardstringfun callback,
+                                         void* user);
+GLFWbool _glfwPlatformGetClipboardDataStream(const char* mime,
+                                             GLFWclipboarddatafun callback,
+                                             void* user);
+void _glfwPlatformSetClipboardDataSource(const char* mime,
+                                         size_t size,
+                                         GLFWclipboardsourcefun callback,
+                                         void* user);
 
 int _glfwPlatformPollJoystick(_GLFWjoystick* js, int mode);
 void _glfwPlatformUpdateGamepadGUID(char* guid);
@@ -673,11 +821,19 @@ void _glfwPlatformSetWindowResizable(_GLFWwindow* window, GLFWbool enabled);
 void _glfwPlatformSetWindowDecorated(_GLFWwindow* window, GLFWbool enabled);
 void _glfwPlatformSetWindowFloating(_GLFWwindow* window, GLFWbool enabled);
 void _glfwPlatformSetWindowOpacity(_GLFWwindow* window, float opacity);
+unsigned char* _glfwPlatformGetWindowPixelBuffer(_GLFWwindow* window,
+                                                 int* width, int* height,
+                                                 int* stride);
+void _glfwPlatformPresentPixelBuffer(_GLFWwindow* window,
+                                     const int* rects, int count);
 
 void _glfwPlatformPollEvents(void);
 void _glfwPlatformWaitEvents(void);
 void _glfwPlatformWaitEventsTimeout(double timeout);
+void _glfwPlatformWaitEventsUntil(uint64_t deadline);
 void _glfwPlatformPostEmptyEvent(void);
+GLFWbool _glfwPlatformAddWaitFd(int fd);
+void _glfwPlatformRemoveWaitFd(int fd);
 
 void _glfwPlatformGetRequiredInstanceExtensions(char** extensions);
 int _glfwPlatformGetPhysicalDevicePresentationSupport(VkInstance instance,
@@ -714,6 +870,10 @@ void _glfwInputWindowMaximize(_GLFWwindow* window, GLFWbool maximized);
 void _glfwInputWindowDamage(_GLFWwindow* window);
 void _glfwInputWindowCloseRequest(_GLFWwindow* window);
 void _glfwInputWindowMonitor(_GLFWwindow* window, _GLFWmonitor* monitor);
+void _glfwInputUserEvent(_GLFWwindow* window, uint64_t payload);
+void _glfwInputWaitFd(int fd);
+void _glfwInputFramePresented(_GLFWwindow* window,
+                              uint64_t time, uint64_t msc, int flags);
 
 void _glfwInputKey(_GLFWwindow* window,
                    int key, int scancode, int action, int mods);
@@ -729,6 +889,8 @@ void _glfwInputJoystickAxis(_GLFWjoystick* js, int axis, float value);
 void _glfwInputJoystickButton(_GLFWjoystick* js, int button, char value);
 void _glfwInputJoystickHat(_GLFWjoystick* js, int hat, char value);
 
+void _glfwInputEventTime(uint64_t time);
+
 void _glfwInputMonitor(_GLFWmonitor* monitor, int action, int placement);
 void _glfwInputMonitorWindow(_GLFWmonitor* monitor, _GLFWwindow* window);
 
@@ -769,6 +931,33 @@ _GLFWjoystick* _glfwAllocJoystick(const char* name,
                                   int hatCount);
 void _glfwFreeJoystick(_GLFWjoystick* js);
 void _glfwCenterCursorInContentArea(_GLFWwindow* window);
+uint64_t _glfwTranslateEventTime(uint32_t milliseconds);
+GLFWevent* _glfwQueueEvent(_GLFWwindow* window, int type);
+void _glfwFlushCoalescedEvents(_GLFWwindow* window);
+
+void _glfwRecordKey(_GLFWwindow* window,
+                    int key, int scancode, int action, int mods);
+void _glfwRecordChar(_GLFWwindow* window,
+                     unsigned int codepoint, int mods, GLFWbool plain);
+void _glfwRecordMouseClick(_GLFWwindow* window, int button, int action, int mods);
+void _glfwRecordCursorPos(_GLFWwindow* window, double xpos, double ypos);
+void _glfwRecordCursorEnter(_GLFWwindow* window, GLFWbool entered);
+void _glfwRecordScroll(_GLFWwindow* window, double xoffset, double yoffset);
+void _glfwRecordWindowPos(_GLFWwindow* window, int xpos, int ypos);
+void _glfwRecordWindowSize(_GLFWwindow* window, int width, int height);
+void _glfwRecordFramebufferSize(_GLFWwindow* window, int width, int height);
+void _glfwRecordWindowFocus(_GLFWwindow* window, GLFWbool focused);
+void _glfwRecordWindowIconify(_GLFWwindow* window, GLFWbool iconified);
+void _glfwRecordWindowMaximize(_GLFWwindow* window, GLFWbool maximized);
+void _glfwRecordWindowContentScale(_GLFWwindow* window,
+                                   float xscale, float yscale);
+void _glfwRecordWindowCloseRequest(_GLFWwindow* window);
+void _glfwRecordJoystickAxis(_GLFWjoystick* js, int axis, float value);
+void _glfwRecordJoystickButton(_GLFWjoystick* js, int button, char value);
+void _glfwRecordJoystickHat(_GLFWjoystick* js, int hat, char value);
+void _glfwRecordFrame(void);
+void _glfwReplayInput(void);
+double _glfwGetReplayTimeout(void);
 
 GLFWbool _glfwInitVulkan(int mode);
 void _glfwTerminateVulkan(void);
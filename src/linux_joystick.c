@@ -38,6 +38,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #ifndef SYN_DROPPED // < v2.6.39 kernel headers
@@ -45,6 +46,11 @@
 #define SYN_DROPPED 3
 #endif
 
+#ifndef input_event_sec // < v4.16 kernel headers
+#define input_event_sec time.tv_sec
+#define input_event_usec time.tv_usec
+#endif
+
 // Apply an EV_KEY event to the specified joystick
 //
 static void handleKeyEvent(_GLFWjoystick* js, int code, int value)
@@ -163,6 +169,19 @@ static GLFWbool openJoystickDevice(const char* path)
         return GLFW_FALSE;
     }
 
+    // Event timestamps use the realtime clock unless told otherwise, so they
+    // can only be reported if they can be made to match the timer
+    if (_glfw.timer.posix.monotonic)
+    {
+#if defined(EVIOCSCLOCKID)
+        int clock = CLOCK_MONOTONIC;
+        if (ioctl(linjs.fd, EVIOCSCLOCKID, &clock) == 0)
+            linjs.timestamped = GLFW_TRUE;
+#endif
+    }
+    else
+        linjs.timestamped = GLFW_TRUE;
+
     char name[256] = "";
 
     if (ioctl(linjs.fd, EVIOCGNAME(sizeof(name)), name) < 0)
@@ -418,6 +437,13 @@ int _glfwPlatformPollJoystick(_GLFWjoystick* js, int mode)
         if (_glfw.linjs.dropped)
             continue;
 
+        if (js->linjs.timestamped)
+        {
+            const uint64_t frequency = _glfwPlatformGetTimerFrequency();
+            _glfwInputEventTime((uint64_t) e.input_event_sec * frequency +
+                                (uint64_t) e.input_event_usec * frequency / 1000000);
+        }
+
         if (e.type == EV_KEY)
             handleKeyEvent(js, e.code, e.value);
         else if (e.type == EV_ABS)
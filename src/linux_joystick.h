@@ -44,6 +44,7 @@ typedef struct _GLFWjoystickLinux
     int                     absMap[ABS_CNT];
     struct input_absinfo    absInfo[ABS_CNT];
     int                     hats[4][2];
+    GLFWbool                timestamped;
 } _GLFWjoystickLinux;
 
 // Linux-specific joystick API data
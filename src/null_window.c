@@ -198,6 +198,22 @@ void _glfwPlatformSetWindowOpacity(_GLFWwindow* window, float opacity)
 {
 }
 
+unsigned char* _glfwPlatformGetWindowPixelBuffer(_GLFWwindow* window,
+                                                 int* width, int* height,
+                                                 int* stride)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Null: Pixel buffers are not supported");
+    return NULL;
+}
+
+void _glfwPlatformPresentPixelBuffer(_GLFWwindow* window,
+                                     const int* rects, int count)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Null: Pixel buffers are not supported");
+}
+
 void _glfwPlatformSetRawMouseMotion(_GLFWwindow *window, GLFWbool enabled)
 {
 }
@@ -255,14 +271,34 @@ void _glfwPlatformWaitEventsTimeout(double timeout)
 {
 }
 
+void _glfwPlatformWaitEventsUntil(uint64_t deadline)
+{
+}
+
 void _glfwPlatformPostEmptyEvent(void)
 {
 }
 
+GLFWbool _glfwPlatformAddWaitFd(int fd)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Null: Waiting on file descriptors is not supported");
+    return GLFW_FALSE;
+}
+
+void _glfwPlatformRemoveWaitFd(int fd)
+{
+}
+
 void _glfwPlatformGetCursorPos(_GLFWwindow* window, double* xpos, double* ypos)
 {
 }
 
+void _glfwPlatformQueryCursorPos(_GLFWwindow* window, double* xpos, double* ypos)
+{
+    _glfwPlatformGetCursorPos(window, xpos, ypos);
+}
+
 void _glfwPlatformSetCursorPos(_GLFWwindow* window, double x, double y)
 {
 }
@@ -300,6 +336,31 @@ const char* _glfwPlatformGetClipboardString(void)
     return NULL;
 }
 
+void _glfwPlatformRequestClipboardString(GLFWclipboardstringfun callback,
+                                         void* user)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Null: Asynchronous clipboard requests are not supported");
+}
+
+GLFWbool _glfwPlatformGetClipboardDataStream(const char* mime,
+                                             GLFWclipboarddatafun callback,
+                                             void* user)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Null: Streaming clipboard retrieval is not supported");
+    return GLFW_FALSE;
+}
+
+void _glfwPlatformSetClipboardDataSource(const char* mime,
+                                         size_t size,
+                                         GLFWclipboardsourcefun callback,
+                                         void* user)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Null: Clipboard data sources are not supported");
+}
+
 const char* _glfwPlatformGetScancodeName(int scancode)
 {
     return "";
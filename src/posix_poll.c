@@ -0,0 +1,108 @@
+//========================================================================
+// GLFW 3.3 POSIX - www.glfw.org
+//------------------------------------------------------------------------
+// Copyright (c) 2002-2006 Marcus Geelnard
+// Copyright (c) 2006-2017 Camilla Löwy <elmindreda@glfw.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+// It is fine to use C99 in this file because it will not be built with VS
+//========================================================================
+
+#define _GNU_SOURCE
+
+#include "internal.h"
+
+#include <signal.h>
+#include <time.h>
+#include <errno.h>
+#include <limits.h>
+
+
+//////////////////////////////////////////////////////////////////////////
+//////                       GLFW internal API                      //////
+//////////////////////////////////////////////////////////////////////////
+
+// Waits until any of the specified file descriptors is ready or the timer
+// reaches the specified deadline, or indefinitely if it is NULL
+// The remaining time is recomputed from the deadline after every wakeup, so
+// interruptions do not accumulate error
+//
+GLFWbool _glfwPollPOSIX(struct pollfd* fds, nfds_t count, const uint64_t* deadline)
+{
+    for (;;)
+    {
+        int result;
+
+        if (deadline)
+        {
+            const uint64_t frequency = _glfwPlatformGetTimerFrequency();
+            const uint64_t now = _glfwPlatformGetTimerValue();
+            const uint64_t remaining = *deadline > now ? *deadline - now : 0;
+
+#if defined(__linux__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__CYGWIN__)
+            const struct timespec ts =
+            {
+                (time_t) (remaining / frequency),
+                (long) ((remaining % frequency) * 1000000000 / frequency)
+            };
+
+            result = ppoll(fds, count, &ts, NULL);
+#else
+            // Round up to whole milliseconds to avoid waking before the deadline
+            const uint64_t unit = frequency / 1000;
+            const uint64_t milliseconds = (remaining + unit - 1) / unit;
+
+            result = poll(fds, count,
+                          milliseconds < INT_MAX ? (int) milliseconds : INT_MAX);
+#endif
+            if (result > 0)
+                return GLFW_TRUE;
+            if (result == -1 && errno != EINTR)
+                return GLFW_FALSE;
+            if (remaining == 0 || _glfwPlatformGetTimerValue() >= *deadline)
+                return GLFW_FALSE;
+        }
+        else
+        {
+            result = poll(fds, count, -1);
+            if (result > 0)
+                return GLFW_TRUE;
+            if (result == -1 && errno != EINTR)
+                return GLFW_FALSE;
+        }
+    }
+}
+
+// Returns the timer value at which the specified relative timeout expires,
+// saturating instead of overflowing
+//
+uint64_t _glfwGetDeadlinePOSIX(double timeout)
+{
+    const uint64_t now = _glfwPlatformGetTimerValue();
+    const double ticks = timeout * (double) _glfwPlatformGetTimerFrequency();
+
+    if (ticks >= (double) (UINT64_MAX - now))
+        return UINT64_MAX;
+
+    return now + (uint64_t) ticks;
+}
+
@@ -0,0 +1,708 @@
+//========================================================================
+// GLFW 3.3 - www.glfw.org
+//------------------------------------------------------------------------
+// Copyright (c) 2002-2006 Marcus Geelnard
+// Copyright (c) 2006-2019 Camilla Löwy <elmindreda@glfw.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+// Please use C89 style variable declarations in this file because VS 2010
+//========================================================================
+
+#include "internal.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+// Input recording format version, stored after the signature
+#define _GLFW_RECORDING_VERSION 1
+
+// Input recording record types
+#define _GLFW_RECORD_FRAME                  0
+#define _GLFW_RECORD_KEY                    1
+#define _GLFW_RECORD_CHAR                   2
+#define _GLFW_RECORD_MOUSE_BUTTON           3
+#define _GLFW_RECORD_CURSOR_POS             4
+#define _GLFW_RECORD_CURSOR_ENTER           5
+#define _GLFW_RECORD_SCROLL                 6
+#define _GLFW_RECORD_WINDOW_POS             7
+#define _GLFW_RECORD_WINDOW_SIZE            8
+#define _GLFW_RECORD_FRAMEBUFFER_SIZE       9
+#define _GLFW_RECORD_WINDOW_FOCUS           10
+#define _GLFW_RECORD_WINDOW_ICONIFY         11
+#define _GLFW_RECORD_WINDOW_MAXIMIZE        12
+#define _GLFW_RECORD_WINDOW_CONTENT_SCALE   13
+#define _GLFW_RECORD_WINDOW_CLOSE           14
+#define _GLFW_RECORD_JOYSTICK_AXIS          15
+#define _GLFW_RECORD_JOYSTICK_BUTTON        16
+#define _GLFW_RECORD_JOYSTICK_HAT           17
+#define _GLFW_RECORD_TYPE_COUNT             18
+
+// Large enough for the encoding of any record
+#define _GLFW_RECORD_MAX_SIZE 64
+
+static const char signature[7] = { 'G', 'L', 'F', 'W', 'R', 'E', 'C' };
+
+// The number of integer and real arguments of each record type
+//
+static const struct
+{
+    int ints, reals;
+} shapes[_GLFW_RECORD_TYPE_COUNT] =
+{
+    { 0, 0 }, // Frame
+    { 4, 0 }, // Key
+    { 3, 0 }, // Char
+    { 3, 0 }, // Mouse button
+    { 0, 2 }, // Cursor position
+    { 1, 0 }, // Cursor enter
+    { 0, 2 }, // Scroll
+    { 2, 0 }, // Window position
+    { 2, 0 }, // Window size
+    { 2, 0 }, // Framebuffer size
+    { 1, 0 }, // Window focus
+    { 1, 0 }, // Window iconify
+    { 1, 0 }, // Window maximize
+    { 0, 2 }, // Window content scale
+    { 0, 0 }, // Window close
+    { 1, 1 }, // Joystick axis
+    { 2, 0 }, // Joystick button
+    { 2, 0 }  // Joystick hat
+};
+
+// Converts a timer value difference to microseconds
+//
+static int64_t timerToMicroseconds(int64_t ticks)
+{
+    const int64_t frequency = (int64_t) _glfwPlatformGetTimerFrequency();
+    return ticks / frequency * 1000000 + ticks % frequency * 1000000 / frequency;
+}
+
+// Converts microseconds to a timer value difference
+//
+static int64_t microsecondsToTimer(int64_t microseconds)
+{
+    const int64_t frequency = (int64_t) _glfwPlatformGetTimerFrequency();
+    return microseconds / 1000000 * frequency +
+           microseconds % 1000000 * frequency / 1000000;
+}
+
+// Encodes an unsigned integer as a variable-length sequence of bytes
+//
+static size_t encodeUnsigned(unsigned char* buffer, uint64_t value)
+{
+    size_t size = 0;
+
+    while (value >= 0x80)
+    {
+        buffer[size++] = (unsigned char) (value | 0x80);
+        value >>= 7;
+    }
+
+    buffer[size++] = (unsigned char) value;
+    return size;
+}
+
+// Encodes a signed integer so that small magnitudes take few bytes
+//
+static size_t encodeSigned(unsigned char* buffer, int64_t value)
+{
+    const uint64_t zigzag = value < 0 ? ~((uint64_t) value << 1)
+                                      : (uint64_t) value << 1;
+    return encodeUnsigned(buffer, zigzag);
+}
+
+// Encodes a real number as its little-endian IEEE 754 representation
+//
+static size_t encodeReal(unsigned char* buffer, double value)
+{
+    int i;
+    uint64_t bits;
+
+    memcpy(&bits, &value, sizeof(bits));
+
+    for (i = 0;  i < 8;  i++)
+        buffer[i] = (unsigned char) (bits >> (i * 8));
+
+    return 8;
+}
+
+static GLFWbool decodeUnsigned(FILE* file, uint64_t* value)
+{
+    int shift;
+
+    *value = 0;
+
+    for (shift = 0;  shift < 64;  shift += 7)
+    {
+        const int byte = getc(file);
+        if (byte == EOF)
+            return GLFW_FALSE;
+
+        *value |= (uint64_t) (byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return GLFW_TRUE;
+    }
+
+    return GLFW_FALSE;
+}
+
+static GLFWbool decodeSigned(FILE* file, int64_t* value)
+{
+    uint64_t zigzag;
+
+    if (!decodeUnsigned(file, &zigzag))
+        return GLFW_FALSE;
+
+    if (zigzag & 1)
+        *value = (int64_t) ~(zigzag >> 1);
+    else
+        *value = (int64_t) (zigzag >> 1);
+
+    return GLFW_TRUE;
+}
+
+static GLFWbool decodeReal(FILE* file, double* value)
+{
+    int i;
+    unsigned char bytes[8];
+    uint64_t bits = 0;
+
+    if (fread(bytes, 1, sizeof(bytes), file) != sizeof(bytes))
+        return GLFW_FALSE;
+
+    for (i = 0;  i < 8;  i++)
+        bits |= (uint64_t) bytes[i] << (i * 8);
+
+    memcpy(value, &bits, sizeof(bits));
+    return GLFW_TRUE;
+}
+
+// Appends a record with the specified timer value to the input recording
+//
+static void writeRecord(int type, int target, uint64_t timer,
+                        const int* ints, const double* reals)
+{
+    int i;
+    size_t size = 0;
+    unsigned char buffer[_GLFW_RECORD_MAX_SIZE];
+    const int64_t time =
+        timerToMicroseconds((int64_t) (timer - _glfw.recorder.base));
+
+    buffer[size++] = (unsigned char) type;
+    size += encodeUnsigned(buffer + size, (uint64_t) target);
+    size += encodeSigned(buffer + size, time - _glfw.recorder.time);
+
+    for (i = 0;  i < shapes[type].ints;  i++)
+        size += encodeSigned(buffer + size, ints[i]);
+    for (i = 0;  i < shapes[type].reals;  i++)
+        size += encodeReal(buffer + size, reals[i]);
+
+    _glfw.recorder.time = time;
+
+    if (fwrite(buffer, 1, size, _glfw.recorder.file) != size)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "Failed to write input recording: %s",
+                        strerror(errno));
+        glfwStopInputRecording();
+    }
+}
+
+// Returns the timer value of the event being processed, or the current one if
+// the platform did not provide it
+//
+static uint64_t getEventTimer(void)
+{
+    if (_glfw.timer.event)
+        return _glfw.timer.event;
+    else
+        return _glfwPlatformGetTimerValue();
+}
+
+static void recordWindow(int type, const _GLFWwindow* window,
+                         const int* ints, const double* reals)
+{
+    writeRecord(type, window->serial, getEventTimer(), ints, reals);
+}
+
+static void recordJoystick(int type, const _GLFWjoystick* js, const int* ints,
+                           const double* reals)
+{
+    writeRecord(type, (int) (js - _glfw.joysticks), getEventTimer(),
+                ints, reals);
+}
+
+// Reads the next record of the input replay into the player
+//
+static GLFWbool readRecord(void)
+{
+    int i, type;
+    uint64_t target;
+    int64_t delta;
+    FILE* file = _glfw.player.file;
+
+    type = getc(file);
+    if (type == EOF)
+        return GLFW_FALSE;
+
+    if (type >= _GLFW_RECORD_TYPE_COUNT ||
+        !decodeUnsigned(file, &target) ||
+        !decodeSigned(file, &delta))
+    {
+        goto corrupt;
+    }
+
+    for (i = 0;  i < shapes[type].ints;  i++)
+    {
+        int64_t value;
+
+        if (!decodeSigned(file, &value) || value < INT_MIN || value > INT_MAX)
+            goto corrupt;
+
+        _glfw.player.ints[i] = (int) value;
+    }
+
+    for (i = 0;  i < shapes[type].reals;  i++)
+    {
+        if (!decodeReal(file, _glfw.player.reals + i))
+            goto corrupt;
+    }
+
+    _glfw.player.type = type;
+    _glfw.player.target = target > INT_MAX ? -1 : (int) target;
+    _glfw.player.time += delta;
+    return GLFW_TRUE;
+
+corrupt:
+    _glfwInputError(GLFW_INVALID_VALUE, "Input replay is truncated or corrupt");
+    return GLFW_FALSE;
+}
+
+// Passes the current record of the input replay through the event API
+//
+static void playRecord(void)
+{
+    const int* ints = _glfw.player.ints;
+    const double* reals = _glfw.player.reals;
+    const int64_t ticks = microsecondsToTimer(_glfw.player.time);
+    uint64_t time = _glfw.player.base + ticks;
+
+    // Zero means the event time is unknown
+    if (time == 0)
+        time = 1;
+
+    _glfwInputEventTime(time);
+
+    if (_glfw.player.type >= _GLFW_RECORD_JOYSTICK_AXIS)
+    {
+        _GLFWjoystick* js;
+
+        if (_glfw.player.target < 0 ||
+            _glfw.player.target > GLFW_JOYSTICK_LAST)
+        {
+            return;
+        }
+
+        js = _glfw.joysticks + _glfw.player.target;
+        if (!js->present)
+            return;
+
+        switch (_glfw.player.type)
+        {
+            case _GLFW_RECORD_JOYSTICK_AXIS:
+                if (ints[0] >= 0 && ints[0] < js->axisCount)
+                    _glfwInputJoystickAxis(js, ints[0], (float) reals[0]);
+                break;
+            case _GLFW_RECORD_JOYSTICK_BUTTON:
+                if (ints[0] >= 0 && ints[0] < js->buttonCount)
+                    _glfwInputJoystickButton(js, ints[0], (char) ints[1]);
+                break;
+            case _GLFW_RECORD_JOYSTICK_HAT:
+                if (ints[0] >= 0 && ints[0] < js->hatCount)
+                    _glfwInputJoystickHat(js, ints[0], (char) ints[1]);
+                break;
+        }
+    }
+    else
+    {
+        _GLFWwindow* window;
+
+        for (window = _glfw.windowListHead;  window;  window = window->next)
+        {
+            if (window->serial == _glfw.player.target)
+                break;
+        }
+
+        if (!window)
+            return;
+
+        switch (_glfw.player.type)
+        {
+            case _GLFW_RECORD_KEY:
+                _glfwInputKey(window, ints[0], ints[1], ints[2], ints[3]);
+                break;
+            case _GLFW_RECORD_CHAR:
+                _glfwInputChar(window, (unsigned int) ints[0], ints[1],
+                               ints[2] ? GLFW_TRUE : GLFW_FALSE);
+                break;
+            case _GLFW_RECORD_MOUSE_BUTTON:
+                _glfwInputMouseClick(window, ints[0], ints[1], ints[2]);
+                break;
+            case _GLFW_RECORD_CURSOR_POS:
+                _glfwInputCursorPos(window, reals[0], reals[1]);
+                break;
+            case _GLFW_RECORD_CURSOR_ENTER:
+                _glfwInputCursorEnter(window, ints[0] ? GLFW_TRUE : GLFW_FALSE);
+                break;
+            case _GLFW_RECORD_SCROLL:
+                _glfwInputScroll(window, reals[0], reals[1]);
+                break;
+            case _GLFW_RECORD_WINDOW_POS:
+                _glfwInputWindowPos(window, ints[0], ints[1]);
+                break;
+            case _GLFW_RECORD_WINDOW_SIZE:
+                _glfwInputWindowSize(window, ints[0], ints[1]);
+                break;
+            case _GLFW_RECORD_FRAMEBUFFER_SIZE:
+                _glfwInputFramebufferSize(window, ints[0], ints[1]);
+                break;
+            case _GLFW_RECORD_WINDOW_FOCUS:
+                _glfwInputWindowFocus(window, ints[0] ? GLFW_TRUE : GLFW_FALSE);
+                break;
+            case _GLFW_RECORD_WINDOW_ICONIFY:
+                _glfwInputWindowIconify(window, ints[0] ? GLFW_TRUE : GLFW_FALSE);
+                break;
+            case _GLFW_RECORD_WINDOW_MAXIMIZE:
+                _glfwInputWindowMaximize(window, ints[0] ? GLFW_TRUE : GLFW_FALSE);
+                break;
+            case _GLFW_RECORD_WINDOW_CONTENT_SCALE:
+                _glfwInputWindowContentScale(window,
+                                             (float) reals[0],
+                                             (float) reals[1]);
+                break;
+            case _GLFW_RECORD_WINDOW_CLOSE:
+                _glfwInputWindowCloseRequest(window);
+                break;
+        }
+    }
+}
+
+// Reads the next record or ends the replay if there are no more
+//
+static void advancePlayer(void)
+{
+    if (!readRecord())
+        glfwStopInputReplay();
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+//////                       GLFW internal API                      //////
+//////////////////////////////////////////////////////////////////////////
+
+void _glfwRecordKey(_GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    const int ints[] = { key, scancode, action, mods };
+    recordWindow(_GLFW_RECORD_KEY, window, ints, NULL);
+}
+
+void _glfwRecordChar(_GLFWwindow* window, unsigned int codepoint, int mods, GLFWbool plain)
+{
+    const int ints[] = { (int) codepoint, mods, plain };
+    recordWindow(_GLFW_RECORD_CHAR, window, ints, NULL);
+}
+
+void _glfwRecordMouseClick(_GLFWwindow* window, int button, int action, int mods)
+{
+    const int ints[] = { button, action, mods };
+    recordWindow(_GLFW_RECORD_MOUSE_BUTTON, window, ints, NULL);
+}
+
+void _glfwRecordCursorPos(_GLFWwindow* window, double xpos, double ypos)
+{
+    const double reals[] = { xpos, ypos };
+    recordWindow(_GLFW_RECORD_CURSOR_POS, window, NULL, reals);
+}
+
+void _glfwRecordCursorEnter(_GLFWwindow* window, GLFWbool entered)
+{
+    const int ints[] = { entered };
+    recordWindow(_GLFW_RECORD_CURSOR_ENTER, window, ints, NULL);
+}
+
+void _glfwRecordScroll(_GLFWwindow* window, double xoffset, double yoffset)
+{
+    const double reals[] = { xoffset, yoffset };
+    recordWindow(_GLFW_RECORD_SCROLL, window, NULL, reals);
+}
+
+void _glfwRecordWindowPos(_GLFWwindow* window, int xpos, int ypos)
+{
+    const int ints[] = { xpos, ypos };
+    recordWindow(_GLFW_RECORD_WINDOW_POS, window, ints, NULL);
+}
+
+void _glfwRecordWindowSize(_GLFWwindow* window, int width, int height)
+{
+    const int ints[] = { width, height };
+    recordWindow(_GLFW_RECORD_WINDOW_SIZE, window, ints, NULL);
+}
+
+void _glfwRecordFramebufferSize(_GLFWwindow* window, int width, int height)
+{
+    const int ints[] = { width, height };
+    recordWindow(_GLFW_RECORD_FRAMEBUFFER_SIZE, window, ints, NULL);
+}
+
+void _glfwRecordWindowFocus(_GLFWwindow* window, GLFWbool focused)
+{
+    const int ints[] = { focused };
+    recordWindow(_GLFW_RECORD_WINDOW_FOCUS, window, ints, NULL);
+}
+
+void _glfwRecordWindowIconify(_GLFWwindow* window, GLFWbool iconified)
+{
+    const int ints[] = { iconified };
+    recordWindow(_GLFW_RECORD_WINDOW_ICONIFY, window, ints, NULL);
+}
+
+void _glfwRecordWindowMaximize(_GLFWwindow* window, GLFWbool maximized)
+{
+    const int ints[] = { maximized };
+    recordWindow(_GLFW_RECORD_WINDOW_MAXIMIZE, window, ints, NULL);
+}
+
+void _glfwRecordWindowContentScale(_GLFWwindow* window, float xscale, float yscale)
+{
+    const double reals[] = { xscale, yscale };
+    recordWindow(_GLFW_RECORD_WINDOW_CONTENT_SCALE, window, NULL, reals);
+}
+
+void _glfwRecordWindowCloseRequest(_GLFWwindow* window)
+{
+    recordWindow(_GLFW_RECORD_WINDOW_CLOSE, window, NULL, NULL);
+}
+
+void _glfwRecordJoystickAxis(_GLFWjoystick* js, int axis, float value)
+{
+    const int ints[] = { axis };
+    const double reals[] = { value };
+    recordJoystick(_GLFW_RECORD_JOYSTICK_AXIS, js, ints, reals);
+}
+
+void _glfwRecordJoystickButton(_GLFWjoystick* js, int button, char value)
+{
+    const int ints[] = { button, value };
+    recordJoystick(_GLFW_RECORD_JOYSTICK_BUTTON, js, ints, NULL);
+}
+
+void _glfwRecordJoystickHat(_GLFWjoystick* js, int hat, char value)
+{
+    const int ints[] = { hat, value };
+    recordJoystick(_GLFW_RECORD_JOYSTICK_HAT, js, ints, NULL);
+}
+
+// Marks the end of a call to an event processing function in the recording
+//
+void _glfwRecordFrame(void)
+{
+    writeRecord(_GLFW_RECORD_FRAME, 0, _glfwPlatformGetTimerValue(), NULL, NULL);
+}
+
+// Passes on the replayed events that are due
+// At maximum speed, this is all events up to and including the next frame
+//
+void _glfwReplayInput(void)
+{
+    int64_t now = 0;
+
+    if (_glfw.player.speed == GLFW_REPLAY_RECORDED_SPEED)
+    {
+        now = timerToMicroseconds((int64_t) (_glfwPlatformGetTimerValue() -
+                                             _glfw.player.base));
+    }
+
+    while (_glfw.player.file)
+    {
+        if (_glfw.player.speed == GLFW_REPLAY_RECORDED_SPEED)
+        {
+            if (_glfw.player.time > now)
+                break;
+        }
+
+        if (_glfw.player.type == _GLFW_RECORD_FRAME)
+        {
+            advancePlayer();
+
+            if (_glfw.player.speed == GLFW_REPLAY_MAXIMUM_SPEED)
+                break;
+        }
+        else
+        {
+            playRecord();
+            advancePlayer();
+        }
+    }
+}
+
+// Returns the time in seconds until the next replayed event is due
+//
+double _glfwGetReplayTimeout(void)
+{
+    int64_t now;
+
+    if (_glfw.player.speed == GLFW_REPLAY_MAXIMUM_SPEED)
+        return 0.0;
+
+    now = timerToMicroseconds((int64_t) (_glfwPlatformGetTimerValue() -
+                                         _glfw.player.base));
+    if (_glfw.player.time <= now)
+        return 0.0;
+
+    return (_glfw.player.time - now) / 1e6;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+//////                        GLFW public API                       //////
+//////////////////////////////////////////////////////////////////////////
+
+GLFWAPI int glfwStartInputRecording(const char* path)
+{
+    FILE* file;
+    unsigned char header[sizeof(signature) + 1];
+
+    assert(path != NULL);
+
+    _GLFW_REQUIRE_INIT_OR_RETURN(GLFW_FALSE);
+
+    glfwStopInputRecording();
+
+    file = fopen(path, "wb");
+    if (!file)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "Failed to open input recording %s: %s",
+                        path, strerror(errno));
+        return GLFW_FALSE;
+    }
+
+    memcpy(header, signature, sizeof(signature));
+    header[sizeof(signature)] = _GLFW_RECORDING_VERSION;
+
+    if (fwrite(header, 1, sizeof(header), file) != sizeof(header))
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "Failed to write input recording %s: %s",
+                        path, strerror(errno));
+        fclose(file);
+        return GLFW_FALSE;
+    }
+
+    _glfw.recorder.file = file;
+    _glfw.recorder.base = _glfwPlatformGetTimerValue();
+    _glfw.recorder.time = 0;
+    return GLFW_TRUE;
+}
+
+GLFWAPI void glfwStopInputRecording(void)
+{
+    _GLFW_REQUIRE_INIT();
+
+    if (!_glfw.recorder.file)
+        return;
+
+    if (fclose(_glfw.recorder.file) != 0)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "Failed to write input recording: %s",
+                        strerror(errno));
+    }
+
+    _glfw.recorder.file = NULL;
+}
+
+GLFWAPI int glfwStartInputReplay(const char* path, int speed)
+{
+    FILE* file;
+    unsigned char header[sizeof(signature) + 1];
+
+    assert(path != NULL);
+
+    _GLFW_REQUIRE_INIT_OR_RETURN(GLFW_FALSE);
+
+    if (speed != GLFW_REPLAY_RECORDED_SPEED &&
+        speed != GLFW_REPLAY_MAXIMUM_SPEED)
+    {
+        _glfwInputError(GLFW_INVALID_ENUM, "Invalid replay speed 0x%08X", speed);
+        return GLFW_FALSE;
+    }
+
+    glfwStopInputReplay();
+
+    file = fopen(path, "rb");
+    if (!file)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "Failed to open input replay %s: %s",
+                        path, strerror(errno));
+        return GLFW_FALSE;
+    }
+
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) ||
+        memcmp(header, signature, sizeof(signature)) != 0 ||
+        header[sizeof(signature)] != _GLFW_RECORDING_VERSION)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE,
+                        "File %s is not a supported input recording", path);
+        fclose(file);
+        return GLFW_FALSE;
+    }
+
+    _glfw.player.file = file;
+    _glfw.player.speed = speed;
+    _glfw.player.base = _glfwPlatformGetTimerValue();
+    _glfw.player.time = 0;
+
+    advancePlayer();
+    return GLFW_TRUE;
+}
+
+GLFWAPI void glfwStopInputReplay(void)
+{
+    _GLFW_REQUIRE_INIT();
+
+    if (!_glfw.player.file)
+        return;
+
+    fclose(_glfw.player.file);
+    _glfw.player.file = NULL;
+}
+
+GLFWAPI int glfwInputReplayActive(void)
+{
+    _GLFW_REQUIRE_INIT_OR_RETURN(GLFW_FALSE);
+    return _glfw.player.file != NULL;
+}
@@ -1909,6 +1909,22 @@ void _glfwPlatformSetWindowOpacity(_GLFWwindow* window, float opacity)
     }
 }
 
+unsigned char* _glfwPlatformGetWindowPixelBuffer(_GLFWwindow* window,
+                                                 int* width, int* height,
+                                                 int* stride)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Win32: Pixel buffers are not supported");
+    return NULL;
+}
+
+void _glfwPlatformPresentPixelBuffer(_GLFWwindow* window,
+                                     const int* rects, int count)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Win32: Pixel buffers are not supported");
+}
+
 void _glfwPlatformSetRawMouseMotion(_GLFWwindow *window, GLFWbool enabled)
 {
     if (_glfw.win32.disabledCursorWindow != window)
@@ -1948,6 +1964,7 @@ void _glfwPlatformPollEvents(void)
         }
         else
         {
+            _glfwInputEventTime(_glfwTranslateEventTime(msg.time));
             TranslateMessage(&msg);
             DispatchMessageW(&msg);
         }
@@ -2021,11 +2038,33 @@ void _glfwPlatformWaitEventsTimeout(double timeout)
     _glfwPlatformPollEvents();
 }
 
+void _glfwPlatformWaitEventsUntil(uint64_t deadline)
+{
+    const uint64_t now = _glfwPlatformGetTimerValue();
+    double timeout = 0.0;
+
+    if (deadline > now)
+        timeout = (deadline - now) / (double) _glfwPlatformGetTimerFrequency();
+
+    _glfwPlatformWaitEventsTimeout(timeout);
+}
+
 void _glfwPlatformPostEmptyEvent(void)
 {
     PostMessage(_glfw.win32.helperWindowHandle, WM_NULL, 0, 0);
 }
 
+GLFWbool _glfwPlatformAddWaitFd(int fd)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Win32: Waiting on file descriptors is not supported");
+    return GLFW_FALSE;
+}
+
+void _glfwPlatformRemoveWaitFd(int fd)
+{
+}
+
 void _glfwPlatformGetCursorPos(_GLFWwindow* window, double* xpos, double* ypos)
 {
     POINT pos;
@@ -2041,6 +2080,11 @@ void _glfwPlatformGetCursorPos(_GLFWwindow* window, double* xpos, double* ypos)
     }
 }
 
+void _glfwPlatformQueryCursorPos(_GLFWwindow* window, double* xpos, double* ypos)
+{
+    _glfwPlatformGetCursorPos(window, xpos, ypos);
+}
+
 void _glfwPlatformSetCursorPos(_GLFWwindow* window, double xpos, double ypos)
 {
     POINT pos = { (int) xpos, (int) ypos };
@@ -2220,6 +2264,31 @@ const char* _glfwPlatformGetClipboardString(void)
     return _glfw.win32.clipboardString;
 }
 
+void _glfwPlatformRequestClipboardString(GLFWclipboardstringfun callback,
+                                         void* user)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Win32: Asynchronous clipboard requests are not supported");
+}
+
+GLFWbool _glfwPlatformGetClipboardDataStream(const char* mime,
+                                             GLFWclipboarddatafun callback,
+                                             void* user)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Win32: Streaming clipboard retrieval is not supported");
+    return GLFW_FALSE;
+}
+
+void _glfwPlatformSetClipboardDataSource(const char* mime,
+                                         size_t size,
+                                         GLFWclipboardsourcefun callback,
+                                         void* user)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Win32: Clipboard data sources are not supported");
+}
+
 void _glfwPlatformGetRequiredInstanceExtensions(char** extensions)
 {
     if (!_glfw.vk.KHR_surface || !_glfw.vk.KHR_win32_surface)
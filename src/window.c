@@ -35,6 +35,86 @@
 #include <stdlib.h>
 #include <float.h>
 
+// Passes on the coalesced events held for all windows
+//
+static void flushCoalescedEvents(void)
+{
+    _GLFWwindow* window;
+
+    for (window = _glfw.windowListHead;  window;  window = window->next)
+        _glfwFlushCoalescedEvents(window);
+}
+
+// Delivers the user events posted since the last call
+//
+static void dispatchUserEvents(void)
+{
+    int i, capacity;
+    _GLFWuserevent* events;
+
+    // Swap the pending and spare arrays so that other threads can keep posting
+    // while the callbacks run
+    _glfwPlatformLockMutex(&_glfw.userEvents.lock);
+
+    events = _glfw.userEvents.pending;
+    capacity = _glfw.userEvents.capacity;
+    _glfw.userEvents.spareCount = _glfw.userEvents.count;
+
+    _glfw.userEvents.pending = _glfw.userEvents.spare;
+    _glfw.userEvents.capacity = _glfw.userEvents.spareCapacity;
+    _glfw.userEvents.count = 0;
+    _glfw.userEvents.spare = events;
+    _glfw.userEvents.spareCapacity = capacity;
+
+    _glfwPlatformUnlockMutex(&_glfw.userEvents.lock);
+
+    // A callback may destroy a window, which clears its remaining spare events
+    for (i = 0;  i < _glfw.userEvents.spareCount;  i++)
+    {
+        if (events[i].window)
+        {
+            _glfwInputEventTime(events[i].time);
+            _glfwInputUserEvent(events[i].window, events[i].payload);
+        }
+    }
+
+    _glfw.userEvents.spareCount = 0;
+}
+
+// Records the state at the start of event processing for all windows
+//
+static void beginEvents(void)
+{
+    _GLFWwindow* window;
+
+    for (window = _glfw.windowListHead;  window;  window = window->next)
+    {
+        memcpy(window->packed.previousKeys, window->packed.keys,
+               sizeof(window->packed.keys));
+        window->packed.previousMouseButtons = window->packed.mouseButtons;
+
+        if (window->transitions.counted)
+            memset(&window->transitions, 0, sizeof(window->transitions));
+
+        window->cursorHistory.head = 0;
+        window->cursorHistory.count = 0;
+    }
+}
+
+// Processes the events that are not the platform's own
+//
+static void finishEvents(void)
+{
+    if (_glfw.player.file)
+        _glfwReplayInput();
+
+    flushCoalescedEvents();
+    dispatchUserEvents();
+
+    if (_glfw.recorder.file)
+        _glfwRecordFrame();
+}
+
 
 //////////////////////////////////////////////////////////////////////////
 //////                         GLFW event API                       //////
@@ -44,6 +124,17 @@
 //
 void _glfwInputWindowFocus(_GLFWwindow* window, GLFWbool focused)
 {
+    if (_glfw.recorder.file)
+        _glfwRecordWindowFocus(window, focused);
+
+    _glfwFlushCoalescedEvents(window);
+
+    if (window->queue.events)
+    {
+        GLFWevent* event = _glfwQueueEvent(window, GLFW_EVENT_WINDOW_FOCUS);
+        event->data.windowFocus.focused = focused;
+    }
+
     if (window->callbacks.focus)
         window->callbacks.focus((GLFWwindow*) window, focused);
 
@@ -73,6 +164,25 @@ void _glfwInputWindowFocus(_GLFWwindow* window, GLFWbool focused)
 //
 void _glfwInputWindowPos(_GLFWwindow* window, int x, int y)
 {
+    if (window->coalesceEvents)
+    {
+        window->pending.pos = GLFW_TRUE;
+        window->pending.xpos = x;
+        window->pending.ypos = y;
+        window->pending.posTime = _glfw.timer.event;
+        return;
+    }
+
+    if (_glfw.recorder.file)
+        _glfwRecordWindowPos(window, x, y);
+
+    if (window->queue.events)
+    {
+        GLFWevent* event = _glfwQueueEvent(window, GLFW_EVENT_WINDOW_POS);
+        event->data.windowPos.x = x;
+        event->data.windowPos.y = y;
+    }
+
     if (window->callbacks.pos)
         window->callbacks.pos((GLFWwindow*) window, x, y);
 }
@@ -82,6 +192,25 @@ void _glfwInputWindowPos(_GLFWwindow* window, int x, int y)
 //
 void _glfwInputWindowSize(_GLFWwindow* window, int width, int height)
 {
+    if (window->coalesceEvents)
+    {
+        window->pending.size = GLFW_TRUE;
+        window->pending.width = width;
+        window->pending.height = height;
+        window->pending.sizeTime = _glfw.timer.event;
+        return;
+    }
+
+    if (_glfw.recorder.file)
+        _glfwRecordWindowSize(window, width, height);
+
+    if (window->queue.events)
+    {
+        GLFWevent* event = _glfwQueueEvent(window, GLFW_EVENT_WINDOW_SIZE);
+        event->data.windowSize.width = width;
+        event->data.windowSize.height = height;
+    }
+
     if (window->callbacks.size)
         window->callbacks.size((GLFWwindow*) window, width, height);
 }
@@ -90,6 +219,17 @@ void _glfwInputWindowSize(_GLFWwindow* window, int width, int height)
 //
 void _glfwInputWindowIconify(_GLFWwindow* window, GLFWbool iconified)
 {
+    if (_glfw.recorder.file)
+        _glfwRecordWindowIconify(window, iconified);
+
+    _glfwFlushCoalescedEvents(window);
+
+    if (window->queue.events)
+    {
+        GLFWevent* event = _glfwQueueEvent(window, GLFW_EVENT_WINDOW_ICONIFY);
+        event->data.windowIconify.iconified = iconified;
+    }
+
     if (window->callbacks.iconify)
         window->callbacks.iconify((GLFWwindow*) window, iconified);
 }
@@ -98,6 +238,17 @@ void _glfwInputWindowIconify(_GLFWwindow* window, GLFWbool iconified)
 //
 void _glfwInputWindowMaximize(_GLFWwindow* window, GLFWbool maximized)
 {
+    if (_glfw.recorder.file)
+        _glfwRecordWindowMaximize(window, maximized);
+
+    _glfwFlushCoalescedEvents(window);
+
+    if (window->queue.events)
+    {
+        GLFWevent* event = _glfwQueueEvent(window, GLFW_EVENT_WINDOW_MAXIMIZE);
+        event->data.windowMaximize.maximized = maximized;
+    }
+
     if (window->callbacks.maximize)
         window->callbacks.maximize((GLFWwindow*) window, maximized);
 }
@@ -107,6 +258,25 @@ void _glfwInputWindowMaximize(_GLFWwindow* window, GLFWbool maximized)
 //
 void _glfwInputFramebufferSize(_GLFWwindow* window, int width, int height)
 {
+    if (window->coalesceEvents)
+    {
+        window->pending.fbsize = GLFW_TRUE;
+        window->pending.fbwidth = width;
+        window->pending.fbheight = height;
+        window->pending.fbsizeTime = _glfw.timer.event;
+        return;
+    }
+
+    if (_glfw.recorder.file)
+        _glfwRecordFramebufferSize(window, width, height);
+
+    if (window->queue.events)
+    {
+        GLFWevent* event = _glfwQueueEvent(window, GLFW_EVENT_FRAMEBUFFER_SIZE);
+        event->data.framebufferSize.width = width;
+        event->data.framebufferSize.height = height;
+    }
+
     if (window->callbacks.fbsize)
         window->callbacks.fbsize((GLFWwindow*) window, width, height);
 }
@@ -116,6 +286,18 @@ void _glfwInputFramebufferSize(_GLFWwindow* window, int width, int height)
 //
 void _glfwInputWindowContentScale(_GLFWwindow* window, float xscale, float yscale)
 {
+    if (_glfw.recorder.file)
+        _glfwRecordWindowContentScale(window, xscale, yscale);
+
+    _glfwFlushCoalescedEvents(window);
+
+    if (window->queue.events)
+    {
+        GLFWevent* event = _glfwQueueEvent(window, GLFW_EVENT_WINDOW_CONTENT_SCALE);
+        event->data.windowContentScale.x = xscale;
+        event->data.windowContentScale.y = yscale;
+    }
+
     if (window->callbacks.scale)
         window->callbacks.scale((GLFWwindow*) window, xscale, yscale);
 }
@@ -124,6 +306,13 @@ void _glfwInputWindowContentScale(_GLFWwindow* window, float xscale, float yscal
 //
 void _glfwInputWindowDamage(_GLFWwindow* window)
 {
+    _glfwFlushCoalescedEvents(window);
+
+    if (window->queue.events)
+    {
+        _glfwQueueEvent(window, GLFW_EVENT_WINDOW_REFRESH);
+    }
+
     if (window->callbacks.refresh)
         window->callbacks.refresh((GLFWwindow*) window);
 }
@@ -132,8 +321,18 @@ void _glfwInputWindowDamage(_GLFWwindow* window)
 //
 void _glfwInputWindowCloseRequest(_GLFWwindow* window)
 {
+    if (_glfw.recorder.file)
+        _glfwRecordWindowCloseRequest(window);
+
+    _glfwFlushCoalescedEvents(window);
+
     window->shouldClose = GLFW_TRUE;
 
+    if (window->queue.events)
+    {
+        _glfwQueueEvent(window, GLFW_EVENT_WINDOW_CLOSE);
+    }
+
     if (window->callbacks.close)
         window->callbacks.close((GLFWwindow*) window);
 }
@@ -145,6 +344,78 @@ void _glfwInputWindowMonitor(_GLFWwindow* window, _GLFWmonitor* monitor)
     window->monitor = monitor;
 }
 
+// Notifies shared code that a user event posted to a window is being delivered
+//
+void _glfwInputUserEvent(_GLFWwindow* window, uint64_t payload)
+{
+    _glfwFlushCoalescedEvents(window);
+
+    if (window->queue.events)
+    {
+        GLFWevent* event = _glfwQueueEvent(window, GLFW_EVENT_USER);
+        event->data.user.payload = payload;
+    }
+
+    if (window->callbacks.user)
+        window->callbacks.user((GLFWwindow*) window, payload);
+}
+
+// Notifies shared code that a file descriptor added with glfwAddWaitFd is ready
+//
+void _glfwInputWaitFd(int fd)
+{
+    int i;
+
+    for (i = 0;  i < _glfw.waitFds.count;  i++)
+    {
+        if (_glfw.waitFds.entries[i].fd == fd)
+        {
+            _glfw.waitFds.entries[i].callback(fd);
+            return;
+        }
+    }
+}
+
+// Notifies shared code that a frame of a window has been shown or skipped
+//
+void _glfwInputFramePresented(_GLFWwindow* window,
+                              uint64_t time, uint64_t msc, int flags)
+{
+    GLFWframetiming* timing;
+
+    _glfwPlatformLockMutex(&_glfw.frameTimingLock);
+
+    if (window->frameTimings.count == GLFW_FRAME_TIMINGS_SIZE)
+    {
+        window->frameTimings.head =
+            (window->frameTimings.head + 1) % GLFW_FRAME_TIMINGS_SIZE;
+        window->frameTimings.count--;
+    }
+
+    timing = window->frameTimings.timings +
+        (window->frameTimings.head + window->frameTimings.count) %
+        GLFW_FRAME_TIMINGS_SIZE;
+    window->frameTimings.count++;
+
+    // Frames are shown in the order they were swapped
+    if (window->frameTimings.submitCount)
+    {
+        timing->submitTime =
+            window->frameTimings.submits[window->frameTimings.submitHead];
+        window->frameTimings.submitHead =
+            (window->frameTimings.submitHead + 1) % GLFW_FRAME_TIMINGS_SIZE;
+        window->frameTimings.submitCount--;
+    }
+    else
+        timing->submitTime = 0;
+
+    timing->presentTime = time;
+    timing->msc = msc;
+    timing->flags = flags;
+
+    _glfwPlatformUnlockMutex(&_glfw.frameTimingLock);
+}
+
 //////////////////////////////////////////////////////////////////////////
 //////                        GLFW public API                       //////
 //////////////////////////////////////////////////////////////////////////
@@ -188,6 +459,7 @@ GLFWAPI GLFWwindow* glfwCreateWindow(int width, int height,
 
     window = calloc(1, sizeof(_GLFWwindow));
     window->next = _glfw.windowListHead;
+    window->serial = _glfw.windowSerial++;
     _glfw.windowListHead = window;
 
     window->videoMode.width       = width;
@@ -203,6 +475,7 @@ GLFWAPI GLFWwindow* glfwCreateWindow(int width, int height,
     window->autoIconify = wndconfig.autoIconify;
     window->floating    = wndconfig.floating;
     window->focusOnShow = wndconfig.focusOnShow;
+    window->coalesceEvents = wndconfig.coalesceEvents;
     window->cursorMode  = GLFW_CURSOR_NORMAL;
 
     window->doublebuffer = fbconfig.doublebuffer;
@@ -377,6 +650,9 @@ GLFWAPI void glfwWindowHint(int hint, int value)
         case GLFW_FOCUS_ON_SHOW:
             _glfw.hints.window.focusOnShow = value ? GLFW_TRUE : GLFW_FALSE;
             return;
+        case GLFW_COALESCE_EVENTS:
+            _glfw.hints.window.coalesceEvents = value ? GLFW_TRUE : GLFW_FALSE;
+            return;
         case GLFW_CLIENT_API:
             _glfw.hints.context.client = value;
             return;
@@ -460,6 +736,27 @@ GLFWAPI void glfwDestroyWindow(GLFWwindow* handle)
 
     _glfwPlatformDestroyWindow(window);
 
+    // Discard user events still waiting to be delivered to the window
+    {
+        int i;
+
+        _glfwPlatformLockMutex(&_glfw.userEvents.lock);
+
+        for (i = 0;  i < _glfw.userEvents.count;  i++)
+        {
+            if (_glfw.userEvents.pending[i].window == window)
+                _glfw.userEvents.pending[i].window = NULL;
+        }
+
+        _glfwPlatformUnlockMutex(&_glfw.userEvents.lock);
+
+        for (i = 0;  i < _glfw.userEvents.spareCount;  i++)
+        {
+            if (_glfw.userEvents.spare[i].window == window)
+                _glfw.userEvents.spare[i].window = NULL;
+        }
+    }
+
     // Unlink window from global linked list
     {
         _GLFWwindow** prev = &_glfw.windowListHead;
@@ -470,6 +767,7 @@ GLFWAPI void glfwDestroyWindow(GLFWwindow* handle)
         *prev = window->next;
     }
 
+    free(window->queue.events);
     free(window);
 }
 
@@ -821,6 +1119,8 @@ GLFWAPI int glfwGetWindowAttrib(GLFWwindow* handle, int attrib)
             return _glfwPlatformWindowHovered(window);
         case GLFW_FOCUS_ON_SHOW:
             return window->focusOnShow;
+        case GLFW_COALESCE_EVENTS:
+            return window->coalesceEvents;
         case GLFW_TRANSPARENT_FRAMEBUFFER:
             return _glfwPlatformFramebufferTransparent(window);
         case GLFW_RESIZABLE:
@@ -899,6 +1199,13 @@ GLFWAPI void glfwSetWindowAttrib(GLFWwindow* handle, int attrib, int value)
     }
     else if (attrib == GLFW_FOCUS_ON_SHOW)
         window->focusOnShow = value;
+    else if (attrib == GLFW_COALESCE_EVENTS)
+    {
+        if (!value)
+            _glfwFlushCoalescedEvents(window);
+
+        window->coalesceEvents = value;
+    }
     else
         _glfwInputError(GLFW_INVALID_ENUM, "Invalid window attribute 0x%08X", attrib);
 }
@@ -951,6 +1258,69 @@ GLFWAPI void glfwSetWindowMonitor(GLFWwindow* wh,
                                   refreshRate);
 }
 
+GLFWAPI unsigned char* glfwGetWindowPixelBuffer(GLFWwindow* handle,
+                                                int* width, int* height,
+                                                int* stride)
+{
+    unsigned char* pixels;
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+    assert(window != NULL);
+
+    if (width)
+        *width = 0;
+    if (height)
+        *height = 0;
+    if (stride)
+        *stride = 0;
+
+    _GLFW_REQUIRE_INIT_OR_RETURN(NULL);
+
+    if (window->context.client != GLFW_NO_API)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE,
+                        "Pixel buffers require the window to have the client API set to GLFW_NO_API");
+        return NULL;
+    }
+
+    pixels = _glfwPlatformGetWindowPixelBuffer(window, width, height, stride);
+    if (!pixels)
+    {
+        if (width)
+            *width = 0;
+        if (height)
+            *height = 0;
+        if (stride)
+            *stride = 0;
+    }
+
+    return pixels;
+}
+
+GLFWAPI void glfwPresentPixelBuffer(GLFWwindow* handle,
+                                    const int* rects, int count)
+{
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+    assert(window != NULL);
+    assert(rects != NULL || count == 0);
+
+    _GLFW_REQUIRE_INIT();
+
+    if (window->context.client != GLFW_NO_API)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE,
+                        "Pixel buffers require the window to have the client API set to GLFW_NO_API");
+        return;
+    }
+
+    if (count < 0)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE, "Invalid area count %i", count);
+        return;
+    }
+
+    _glfwPlatformPresentPixelBuffer(window, rects, count);
+}
+
 GLFWAPI void glfwSetWindowUserPointer(GLFWwindow* handle, void* pointer)
 {
     _GLFWwindow* window = (_GLFWwindow*) handle;
@@ -1068,16 +1438,37 @@ GLFWAPI GLFWwindowcontentscalefun glfwSetWindowContentScaleCallback(GLFWwindow*
     return cbfun;
 }
 
+GLFWAPI GLFWusereventfun glfwSetUserEventCallback(GLFWwindow* handle,
+                                                  GLFWusereventfun cbfun)
+{
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+    assert(window != NULL);
+
+    _GLFW_REQUIRE_INIT_OR_RETURN(NULL);
+    _GLFW_SWAP_POINTERS(window->callbacks.user, cbfun);
+    return cbfun;
+}
+
 GLFWAPI void glfwPollEvents(void)
 {
     _GLFW_REQUIRE_INIT();
+    beginEvents();
     _glfwPlatformPollEvents();
+    finishEvents();
 }
 
 GLFWAPI void glfwWaitEvents(void)
 {
     _GLFW_REQUIRE_INIT();
-    _glfwPlatformWaitEvents();
+    beginEvents();
+
+    // Wake up in time for the next replayed event
+    if (_glfw.player.file)
+        _glfwPlatformWaitEventsTimeout(_glfwGetReplayTimeout());
+    else
+        _glfwPlatformWaitEvents();
+
+    finishEvents();
 }
 
 GLFWAPI void glfwWaitEventsTimeout(double timeout)
@@ -1093,7 +1484,37 @@ GLFWAPI void glfwWaitEventsTimeout(double timeout)
         return;
     }
 
+    beginEvents();
+
+    // Wake up in time for the next replayed event
+    if (_glfw.player.file)
+    {
+        const double replayTimeout = _glfwGetReplayTimeout();
+        if (timeout > replayTimeout)
+            timeout = replayTimeout;
+    }
+
     _glfwPlatformWaitEventsTimeout(timeout);
+    finishEvents();
+}
+
+GLFWAPI void glfwWaitEventsUntil(uint64_t value)
+{
+    _GLFW_REQUIRE_INIT();
+
+    beginEvents();
+
+    // Wake up in time for the next replayed event
+    if (_glfw.player.file)
+    {
+        const uint64_t replayDeadline = _glfwPlatformGetTimerValue() +
+            (uint64_t) (_glfwGetReplayTimeout() * _glfwPlatformGetTimerFrequency());
+        if (value > replayDeadline)
+            value = replayDeadline;
+    }
+
+    _glfwPlatformWaitEventsUntil(value);
+    finishEvents();
 }
 
 GLFWAPI void glfwPostEmptyEvent(void)
@@ -1102,3 +1523,111 @@ GLFWAPI void glfwPostEmptyEvent(void)
     _glfwPlatformPostEmptyEvent();
 }
 
+GLFWAPI void glfwPostUserEvent(GLFWwindow* handle, uint64_t payload)
+{
+    GLFWbool wake;
+    _GLFWuserevent* event;
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+    assert(window != NULL);
+
+    _GLFW_REQUIRE_INIT();
+
+    _glfwPlatformLockMutex(&_glfw.userEvents.lock);
+
+    if (_glfw.userEvents.count == _glfw.userEvents.capacity)
+    {
+        const int capacity = _glfw.userEvents.capacity ?
+                             _glfw.userEvents.capacity * 2 : 64;
+        _GLFWuserevent* events = realloc(_glfw.userEvents.pending,
+                                         capacity * sizeof(_GLFWuserevent));
+        if (!events)
+        {
+            _glfwPlatformUnlockMutex(&_glfw.userEvents.lock);
+            _glfwInputError(GLFW_OUT_OF_MEMORY,
+                            "Failed to grow the user event queue");
+            return;
+        }
+
+        _glfw.userEvents.pending = events;
+        _glfw.userEvents.capacity = capacity;
+    }
+
+    event = _glfw.userEvents.pending + _glfw.userEvents.count++;
+    event->window = window;
+    event->payload = payload;
+    event->time = _glfwPlatformGetTimerValue();
+
+    // Only the first event since the last delivery needs to wake the main
+    // thread, as the rest will be delivered along with it
+    wake = (_glfw.userEvents.count == 1);
+
+    _glfwPlatformUnlockMutex(&_glfw.userEvents.lock);
+
+    if (wake)
+        _glfwPlatformPostEmptyEvent();
+}
+
+GLFWAPI int glfwAddWaitFd(int fd, GLFWwaitfdfun callback)
+{
+    int i;
+    _GLFWwaitfd* entries;
+
+    assert(callback != NULL);
+
+    _GLFW_REQUIRE_INIT_OR_RETURN(GLFW_FALSE);
+
+    if (fd < 0)
+    {
+        _glfwInputError(GLFW_INVALID_VALUE, "Invalid file descriptor %i", fd);
+        return GLFW_FALSE;
+    }
+
+    for (i = 0;  i < _glfw.waitFds.count;  i++)
+    {
+        if (_glfw.waitFds.entries[i].fd == fd)
+        {
+            _glfw.waitFds.entries[i].callback = callback;
+            return GLFW_TRUE;
+        }
+    }
+
+    entries = realloc(_glfw.waitFds.entries,
+                      (_glfw.waitFds.count + 1) * sizeof(_GLFWwaitfd));
+    if (!entries)
+    {
+        _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+        return GLFW_FALSE;
+    }
+
+    _glfw.waitFds.entries = entries;
+
+    if (!_glfwPlatformAddWaitFd(fd))
+        return GLFW_FALSE;
+
+    entries[_glfw.waitFds.count].fd = fd;
+    entries[_glfw.waitFds.count].callback = callback;
+    _glfw.waitFds.count++;
+    return GLFW_TRUE;
+}
+
+GLFWAPI void glfwRemoveWaitFd(int fd)
+{
+    int i;
+
+    _GLFW_REQUIRE_INIT();
+
+    for (i = 0;  i < _glfw.waitFds.count;  i++)
+    {
+        if (_glfw.waitFds.entries[i].fd == fd)
+        {
+            _glfwPlatformRemoveWaitFd(fd);
+
+            _glfw.waitFds.count--;
+            memmove(_glfw.waitFds.entries + i,
+                    _glfw.waitFds.entries + i + 1,
+                    (_glfw.waitFds.count - i) * sizeof(_GLFWwaitfd));
+            return;
+        }
+    }
+}
+
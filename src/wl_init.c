@@ -32,6 +32,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
 #include <linux/input.h>
 #include <stdio.h>
@@ -110,6 +111,7 @@ static void pointerHandleEnter(void* data,
     window->wl.hovered = GLFW_TRUE;
 
     _glfwPlatformSetCursor(window, window->wl.currentCursor);
+    _glfwInputEventTime(0);
     _glfwInputCursorEnter(window, GLFW_TRUE);
 }
 
@@ -127,6 +129,7 @@ static void pointerHandleLeave(void* data,
 
     _glfw.wl.serial = serial;
     _glfw.wl.pointerFocus = NULL;
+    _glfwInputEventTime(0);
     _glfwInputCursorEnter(window, GLFW_FALSE);
     _glfw.wl.cursorPreviousName = NULL;
 }
@@ -199,6 +202,7 @@ static void pointerHandleMotion(void* data,
         case mainWindow:
             window->wl.cursorPosX = x;
             window->wl.cursorPosY = y;
+            _glfwInputEventTime(_glfwTranslateEventTime(time));
             _glfwInputCursorPos(window, x, y);
             _glfw.wl.cursorPreviousName = NULL;
             return;
@@ -322,6 +326,7 @@ static void pointerHandleButton(void* data,
      * codes. */
     glfwButton = button - BTN_LEFT;
 
+    _glfwInputEventTime(_glfwTranslateEventTime(time));
     _glfwInputMouseClick(window,
                          glfwButton,
                          state == WL_POINTER_BUTTON_STATE_PRESSED
@@ -354,6 +359,7 @@ static void pointerHandleAxis(void* data,
     else if (axis == WL_POINTER_AXIS_VERTICAL_SCROLL)
         y = -wl_fixed_to_double(value) * scrollFactor;
 
+    _glfwInputEventTime(_glfwTranslateEventTime(time));
     _glfwInputScroll(window, x, y);
 }
 
@@ -487,6 +493,7 @@ static void keyboardHandleEnter(void* data,
 
     _glfw.wl.serial = serial;
     _glfw.wl.keyboardFocus = window;
+    _glfwInputEventTime(0);
     _glfwInputWindowFocus(window, GLFW_TRUE);
 }
 
@@ -502,6 +509,7 @@ static void keyboardHandleLeave(void* data,
 
     _glfw.wl.serial = serial;
     _glfw.wl.keyboardFocus = NULL;
+    _glfwInputEventTime(0);
     _glfwInputWindowFocus(window, GLFW_FALSE);
 }
 
@@ -585,6 +593,7 @@ static void keyboardHandleKey(void* data,
             ? GLFW_PRESS : GLFW_RELEASE;
 
     _glfw.wl.serial = serial;
+    _glfwInputEventTime(_glfwTranslateEventTime(time));
     _glfwInputKey(window, keyCode, key, action,
                   _glfw.wl.xkb.modifiers);
 
@@ -1041,6 +1050,68 @@ static void createKeyTables(void)
 }
 
 
+// Create the pipe used to wake up the event loop from any thread
+//
+static GLFWbool createEmptyEventPipe(void)
+{
+    int i;
+
+    if (pipe(_glfw.wl.emptyEventPipe) != 0)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "Wayland: Failed to create empty event pipe: %s",
+                        strerror(errno));
+        return GLFW_FALSE;
+    }
+
+    for (i = 0;  i < 2;  i++)
+    {
+        const int sf = fcntl(_glfw.wl.emptyEventPipe[i], F_GETFL, 0);
+        const int df = fcntl(_glfw.wl.emptyEventPipe[i], F_GETFD, 0);
+
+        if (sf == -1 || df == -1 ||
+            fcntl(_glfw.wl.emptyEventPipe[i], F_SETFL, sf | O_NONBLOCK) == -1 ||
+            fcntl(_glfw.wl.emptyEventPipe[i], F_SETFD, df | FD_CLOEXEC) == -1)
+        {
+            _glfwInputError(GLFW_PLATFORM_ERROR,
+                            "Wayland: Failed to set flags for empty event pipe: %s",
+                            strerror(errno));
+            return GLFW_FALSE;
+        }
+    }
+
+    return GLFW_TRUE;
+}
+
+// Create the set of descriptors waited on for events
+//
+static GLFWbool createPollSet(void)
+{
+    int i;
+
+    _glfw.wl.pollfds = calloc(_GLFW_WL_POLL_COUNT, sizeof(struct pollfd));
+    if (!_glfw.wl.pollfds)
+    {
+        _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+        return GLFW_FALSE;
+    }
+
+    _glfw.wl.pollfdCount = _GLFW_WL_POLL_COUNT;
+
+    for (i = 0;  i < _GLFW_WL_POLL_COUNT;  i++)
+        _glfw.wl.pollfds[i].events = POLLIN;
+
+    // NOTE: Timers that were not created are negative and ignored by poll
+    _glfw.wl.pollfds[_GLFW_WL_POLL_DISPLAY].fd =
+        wl_display_get_fd(_glfw.wl.display);
+    _glfw.wl.pollfds[_GLFW_WL_POLL_KEY_REPEAT].fd = _glfw.wl.timerfd;
+    _glfw.wl.pollfds[_GLFW_WL_POLL_CURSOR].fd = _glfw.wl.cursorTimerfd;
+    _glfw.wl.pollfds[_GLFW_WL_POLL_EMPTY_EVENT].fd = _glfw.wl.emptyEventPipe[0];
+
+    return GLFW_TRUE;
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 //////                       GLFW platform API                      //////
 //////////////////////////////////////////////////////////////////////////
@@ -1167,7 +1238,11 @@ int _glfwPlatformInit(void)
 
     _glfwInitTimerPOSIX();
 
+    if (!createEmptyEventPipe())
+        return GLFW_FALSE;
+
     _glfw.wl.timerfd = -1;
+    _glfw.wl.cursorTimerfd = -1;
     if (_glfw.wl.seatVersion >= 4)
         _glfw.wl.timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
 
@@ -1215,6 +1290,9 @@ int _glfwPlatformInit(void)
         _glfw.wl.clipboardSize = 4096;
     }
 
+    if (!createPollSet())
+        return GLFW_FALSE;
+
     return GLFW_TRUE;
 }
 
@@ -1304,11 +1382,27 @@ void _glfwPlatformTerminate(void)
         close(_glfw.wl.timerfd);
     if (_glfw.wl.cursorTimerfd >= 0)
         close(_glfw.wl.cursorTimerfd);
+    free(_glfw.wl.pollfds);
+    if (_glfw.wl.emptyEventPipe[0] || _glfw.wl.emptyEventPipe[1])
+    {
+        close(_glfw.wl.emptyEventPipe[0]);
+        close(_glfw.wl.emptyEventPipe[1]);
+    }
 
     if (_glfw.wl.clipboardString)
         free(_glfw.wl.clipboardString);
     if (_glfw.wl.clipboardSendString)
         free(_glfw.wl.clipboardSendString);
+
+    for (int i = 0;  i < _glfw.wl.clipboardRequests.count;  i++)
+    {
+        if (_glfw.wl.clipboardRequests.entries[i].fd != -1)
+            close(_glfw.wl.clipboardRequests.entries[i].fd);
+
+        free(_glfw.wl.clipboardRequests.entries[i].data);
+    }
+
+    free(_glfw.wl.clipboardRequests.entries);
 }
 
 const char* _glfwPlatformGetVersionString(void)
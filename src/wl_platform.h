@@ -47,6 +47,7 @@ typedef VkBool32 (APIENTRY *PFN_vkGetPhysicalDeviceWaylandPresentationSupportKHR
 
 #include "posix_thread.h"
 #include "posix_time.h"
+#include "posix_poll.h"
 #ifdef __linux__
 #include "linux_joystick.h"
 #else
@@ -75,6 +76,14 @@ typedef VkBool32 (APIENTRY *PFN_vkGetPhysicalDeviceWaylandPresentationSupportKHR
 #define _GLFW_PLATFORM_MONITOR_STATE        _GLFWmonitorWayland wl
 #define _GLFW_PLATFORM_CURSOR_STATE         _GLFWcursorWayland  wl
 
+// Indices of the descriptors waited on for events, which are followed by those
+// added with glfwAddWaitFd
+#define _GLFW_WL_POLL_DISPLAY       0
+#define _GLFW_WL_POLL_KEY_REPEAT    1
+#define _GLFW_WL_POLL_CURSOR        2
+#define _GLFW_WL_POLL_EMPTY_EVENT   3
+#define _GLFW_WL_POLL_COUNT         4
+
 #define _GLFW_PLATFORM_CONTEXT_STATE         struct { int dummyContext; }
 #define _GLFW_PLATFORM_LIBRARY_CONTEXT_STATE struct { int dummyLibraryContext; }
 
@@ -167,6 +176,18 @@ typedef struct _GLFWdecorationWayland
     struct wp_viewport*         viewport;
 } _GLFWdecorationWayland;
 
+// Wayland-specific asynchronous clipboard request
+//
+typedef struct _GLFWclipboardrequestWayland
+{
+    // Read end of the pipe receiving the offer, or -1 if answered locally
+    int                         fd;
+    char*                       data;
+    size_t                      size;
+    GLFWclipboardstringfun      callback;
+    void*                       user;
+} _GLFWclipboardrequestWayland;
+
 // Wayland-specific per-window data
 //
 typedef struct _GLFWwindowWayland
@@ -248,6 +269,10 @@ typedef struct _GLFWlibraryWayland
     struct wl_surface*          cursorSurface;
     const char*                 cursorPreviousName;
     int                         cursorTimerfd;
+    int                         emptyEventPipe[2];
+    // Descriptors waited on for events, indexed by _GLFW_WL_POLL_*
+    struct pollfd*              pollfds;
+    int                         pollfdCount;
     uint32_t                    serial;
     uint32_t                    pointerEnterSerial;
 
@@ -259,6 +284,11 @@ typedef struct _GLFWlibraryWayland
     size_t                      clipboardSize;
     char*                       clipboardSendString;
     size_t                      clipboardSendSize;
+    // Asynchronous clipboard requests awaiting a reply
+    struct {
+        _GLFWclipboardrequestWayland* entries;
+        int                     count;
+    } clipboardRequests;
     int                         timerfd;
     short int                   keycodes[256];
     short int                   scancodes[GLFW_KEY_LAST + 1];
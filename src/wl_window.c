@@ -823,14 +823,13 @@ static void incrementCursorImage(_GLFWwindow* window)
     }
 }
 
-static void handleEvents(int timeout)
+// Processes Wayland events and the timers, waiting until the specified timer
+// deadline or indefinitely if it is NULL
+//
+static void handleEvents(const uint64_t* deadline)
 {
     struct wl_display* display = _glfw.wl.display;
-    struct pollfd fds[] = {
-        { wl_display_get_fd(display), POLLIN },
-        { _glfw.wl.timerfd, POLLIN },
-        { _glfw.wl.cursorTimerfd, POLLIN },
-    };
+    struct pollfd* fds = _glfw.wl.pollfds;
     ssize_t read_ret;
     uint64_t repeats, i;
 
@@ -852,9 +851,9 @@ static void handleEvents(int timeout)
         return;
     }
 
-    if (poll(fds, 3, timeout) > 0)
+    if (_glfwPollPOSIX(fds, _glfw.wl.pollfdCount, deadline))
     {
-        if (fds[0].revents & POLLIN)
+        if (fds[_GLFW_WL_POLL_DISPLAY].revents & POLLIN)
         {
             wl_display_read_events(display);
             wl_display_dispatch_pending(display);
@@ -864,7 +863,7 @@ static void handleEvents(int timeout)
             wl_display_cancel_read(display);
         }
 
-        if (fds[1].revents & POLLIN)
+        if (fds[_GLFW_WL_POLL_KEY_REPEAT].revents & POLLIN)
         {
             read_ret = read(_glfw.wl.timerfd, &repeats, sizeof(repeats));
             if (read_ret != 8)
@@ -872,6 +871,8 @@ static void handleEvents(int timeout)
 
             if (_glfw.wl.keyboardFocus)
             {
+                _glfwInputEventTime(0);
+
                 for (i = 0; i < repeats; ++i)
                 {
                     _glfwInputKey(_glfw.wl.keyboardFocus,
@@ -883,7 +884,7 @@ static void handleEvents(int timeout)
             }
         }
 
-        if (fds[2].revents & POLLIN)
+        if (fds[_GLFW_WL_POLL_CURSOR].revents & POLLIN)
         {
             read_ret = read(_glfw.wl.cursorTimerfd, &repeats, sizeof(repeats));
             if (read_ret != 8)
@@ -891,6 +892,14 @@ static void handleEvents(int timeout)
 
             incrementCursorImage(_glfw.wl.pointerFocus);
         }
+
+        if (fds[_GLFW_WL_POLL_EMPTY_EVENT].revents & POLLIN)
+        {
+            char dummy[64];
+
+            while (read(_glfw.wl.emptyEventPipe[0], dummy, sizeof(dummy)) > 0)
+                ;
+        }
     }
     else
     {
@@ -898,6 +907,181 @@ static void handleEvents(int timeout)
     }
 }
 
+// Returns the asynchronous clipboard request reading from the specified
+// descriptor
+//
+static _GLFWclipboardrequestWayland* findClipboardRequest(int fd)
+{
+    for (int i = 0;  i < _glfw.wl.clipboardRequests.count;  i++)
+    {
+        _GLFWclipboardrequestWayland* request = _glfw.wl.clipboardRequests.entries + i;
+        if (request->fd == fd)
+            return request;
+    }
+
+    return NULL;
+}
+
+// Passes the string of an asynchronous clipboard request already removed from
+// the request list to its callback
+//
+static void finishClipboardRequest(_GLFWclipboardrequestWayland* request,
+                                   GLFWbool success)
+{
+    if (request->fd != -1)
+    {
+        _glfwPlatformRemoveWaitFd(request->fd);
+        close(request->fd);
+    }
+
+    if (!success)
+    {
+        free(request->data);
+        request->data = NULL;
+        _glfwInputError(GLFW_FORMAT_UNAVAILABLE,
+                        "Wayland: Failed to receive clipboard string");
+    }
+    else if (!request->data)
+        request->data = _glfw_strdup("");
+
+    request->callback(request->data, request->user);
+    free(request->data);
+}
+
+// Removes the specified asynchronous clipboard request and passes its string
+// to the callback
+//
+static void completeClipboardRequest(_GLFWclipboardrequestWayland* request,
+                                     GLFWbool success)
+{
+    _GLFWclipboardrequestWayland completed = *request;
+
+    // The callback may issue another request, so remove this one first
+    *request = _glfw.wl.clipboardRequests.entries[--_glfw.wl.clipboardRequests.count];
+
+    finishClipboardRequest(&completed, success);
+}
+
+// Completes the asynchronous clipboard requests answered without the
+// compositor, in the order they were made
+//
+static void completeLocalClipboardRequests(void)
+{
+    int i, count = 0, remaining = 0;
+    _GLFWclipboardrequestWayland* local;
+
+    for (i = 0;  i < _glfw.wl.clipboardRequests.count;  i++)
+    {
+        if (_glfw.wl.clipboardRequests.entries[i].fd == -1)
+            count++;
+    }
+
+    if (!count)
+        return;
+
+    local = calloc(count, sizeof(_GLFWclipboardrequestWayland));
+    if (!local)
+    {
+        _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+        return;
+    }
+
+    // The callbacks may issue other requests, so remove these ones first
+    count = 0;
+
+    for (i = 0;  i < _glfw.wl.clipboardRequests.count;  i++)
+    {
+        const _GLFWclipboardrequestWayland* request =
+            _glfw.wl.clipboardRequests.entries + i;
+
+        if (request->fd == -1)
+            local[count++] = *request;
+        else
+            _glfw.wl.clipboardRequests.entries[remaining++] = *request;
+    }
+
+    _glfw.wl.clipboardRequests.count = remaining;
+
+    for (i = 0;  i < count;  i++)
+        finishClipboardRequest(local + i, local[i].data != NULL);
+
+    free(local);
+}
+
+// Reads the next part of the reply to an asynchronous clipboard request,
+// returning whether the descriptor belongs to one
+//
+static GLFWbool handleClipboardRequestFd(int fd)
+{
+    char buffer[4096];
+    ssize_t count;
+    char* data;
+    _GLFWclipboardrequestWayland* request = findClipboardRequest(fd);
+    if (!request)
+        return GLFW_FALSE;
+
+    count = read(fd, buffer, sizeof(buffer));
+    if (count == -1)
+    {
+        if (errno != EINTR && errno != EAGAIN)
+            completeClipboardRequest(request, GLFW_FALSE);
+
+        return GLFW_TRUE;
+    }
+
+    // The offer has been sent in full once the source closes its end
+    if (count == 0)
+    {
+        completeClipboardRequest(request, GLFW_TRUE);
+        return GLFW_TRUE;
+    }
+
+    data = realloc(request->data, request->size + count + 1);
+    if (!data)
+    {
+        _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+        completeClipboardRequest(request, GLFW_FALSE);
+        return GLFW_TRUE;
+    }
+
+    memcpy(data + request->size, buffer, count);
+    data[request->size + count] = '\0';
+    request->data = data;
+    request->size += count;
+    return GLFW_TRUE;
+}
+
+// Calls the callbacks of the file descriptors added with glfwAddWaitFd that are
+// ready
+//
+static void dispatchWaitFds(void)
+{
+    int i;
+    const int count = _glfw.wl.pollfdCount - _GLFW_WL_POLL_COUNT;
+
+    if (count <= 0)
+        return;
+
+    if (poll(_glfw.wl.pollfds + _GLFW_WL_POLL_COUNT, count, 0) <= 0)
+        return;
+
+    // NOTE: A callback may add or remove descriptors, so the array is re-read
+    //       on each iteration and a ready descriptor shifted to an index that
+    //       was already visited is handled by the next call instead
+    for (i = _GLFW_WL_POLL_COUNT;  i < _glfw.wl.pollfdCount;  i++)
+    {
+        if (_glfw.wl.pollfds[i].revents)
+        {
+            const int fd = _glfw.wl.pollfds[i].fd;
+            _glfw.wl.pollfds[i].revents = 0;
+
+            // The reads of clipboard requests share the set of descriptors
+            if (!handleClipboardRequestFd(fd))
+                _glfwInputWaitFd(fd);
+        }
+    }
+}
+
 // Translates a GLFW standard cursor to a theme cursor name
 //
 static char *translateCursorShape(int shape)
@@ -1329,6 +1513,22 @@ void _glfwPlatformSetWindowOpacity(_GLFWwindow* window, float opacity)
 {
 }
 
+unsigned char* _glfwPlatformGetWindowPixelBuffer(_GLFWwindow* window,
+                                                 int* width, int* height,
+                                                 int* stride)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Wayland: Pixel buffers are not supported");
+    return NULL;
+}
+
+void _glfwPlatformPresentPixelBuffer(_GLFWwindow* window,
+                                     const int* rects, int count)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Wayland: Pixel buffers are not supported");
+}
+
 void _glfwPlatformSetRawMouseMotion(_GLFWwindow *window, GLFWbool enabled)
 {
     // This is handled in relativePointerHandleRelativeMotion
@@ -1341,22 +1541,76 @@ GLFWbool _glfwPlatformRawMouseMotionSupported(void)
 
 void _glfwPlatformPollEvents(void)
 {
-    handleEvents(0);
+    // A deadline in the past makes handleEvents poll without waiting
+    const uint64_t deadline = 0;
+
+    handleEvents(&deadline);
+    completeLocalClipboardRequests();
+    dispatchWaitFds();
 }
 
 void _glfwPlatformWaitEvents(void)
 {
-    handleEvents(-1);
+    handleEvents(NULL);
+    completeLocalClipboardRequests();
+    dispatchWaitFds();
 }
 
 void _glfwPlatformWaitEventsTimeout(double timeout)
 {
-    handleEvents((int) (timeout * 1e3));
+    _glfwPlatformWaitEventsUntil(_glfwGetDeadlinePOSIX(timeout));
+}
+
+void _glfwPlatformWaitEventsUntil(uint64_t deadline)
+{
+    handleEvents(&deadline);
+    completeLocalClipboardRequests();
+    dispatchWaitFds();
 }
 
 void _glfwPlatformPostEmptyEvent(void)
 {
-    wl_display_sync(_glfw.wl.display);
+    const char byte = 0;
+
+    while (write(_glfw.wl.emptyEventPipe[1], &byte, 1) == -1 && errno == EINTR)
+        ;
+}
+
+GLFWbool _glfwPlatformAddWaitFd(int fd)
+{
+    struct pollfd* pollfds = realloc(_glfw.wl.pollfds,
+                                     (_glfw.wl.pollfdCount + 1) *
+                                     sizeof(struct pollfd));
+    if (!pollfds)
+    {
+        _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+        return GLFW_FALSE;
+    }
+
+    pollfds[_glfw.wl.pollfdCount].fd = fd;
+    pollfds[_glfw.wl.pollfdCount].events = POLLIN;
+    pollfds[_glfw.wl.pollfdCount].revents = 0;
+
+    _glfw.wl.pollfds = pollfds;
+    _glfw.wl.pollfdCount++;
+    return GLFW_TRUE;
+}
+
+void _glfwPlatformRemoveWaitFd(int fd)
+{
+    int i;
+
+    for (i = _GLFW_WL_POLL_COUNT;  i < _glfw.wl.pollfdCount;  i++)
+    {
+        if (_glfw.wl.pollfds[i].fd == fd)
+        {
+            _glfw.wl.pollfdCount--;
+            memmove(_glfw.wl.pollfds + i,
+                    _glfw.wl.pollfds + i + 1,
+                    (_glfw.wl.pollfdCount - i) * sizeof(struct pollfd));
+            return;
+        }
+    }
 }
 
 void _glfwPlatformGetCursorPos(_GLFWwindow* window, double* xpos, double* ypos)
@@ -1367,6 +1621,11 @@ void _glfwPlatformGetCursorPos(_GLFWwindow* window, double* xpos, double* ypos)
         *ypos = window->wl.cursorPosY;
 }
 
+void _glfwPlatformQueryCursorPos(_GLFWwindow* window, double* xpos, double* ypos)
+{
+    _glfwPlatformGetCursorPos(window, xpos, ypos);
+}
+
 static GLFWbool isPointerLocked(_GLFWwindow* window);
 
 void _glfwPlatformSetCursorPos(_GLFWwindow* window, double x, double y)
@@ -1475,6 +1734,9 @@ static void relativePointerHandleRelativeMotion(void* data,
         ypos += wl_fixed_to_double(dy);
     }
 
+    // The relative pointer protocol timestamps events in microseconds
+    _glfwInputEventTime(_glfwTranslateEventTime(
+        (uint32_t) ((((uint64_t) timeHi << 32) | timeLo) / 1000)));
     _glfwInputCursorPos(window, xpos, ypos);
 }
 
@@ -1779,7 +2041,7 @@ const char* _glfwPlatformGetClipboardString(void)
     close(fds[1]);
 
     // XXX: this is a huge hack, this function shouldn’t be synchronous!
-    handleEvents(-1);
+    handleEvents(NULL);
 
     while (1)
     {
@@ -1820,6 +2082,85 @@ const char* _glfwPlatformGetClipboardString(void)
     return _glfw.wl.clipboardString;
 }
 
+void _glfwPlatformRequestClipboardString(GLFWclipboardstringfun callback,
+                                         void* user)
+{
+    int fds[2];
+    _GLFWclipboardrequestWayland* entries;
+    _GLFWclipboardrequestWayland* request;
+
+    entries = realloc(_glfw.wl.clipboardRequests.entries,
+                      sizeof(_GLFWclipboardrequestWayland) *
+                      (_glfw.wl.clipboardRequests.count + 1));
+    if (!entries)
+    {
+        _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+        return;
+    }
+
+    _glfw.wl.clipboardRequests.entries = entries;
+    request = entries + _glfw.wl.clipboardRequests.count++;
+    memset(request, 0, sizeof(_GLFWclipboardrequestWayland));
+    request->fd = -1;
+    request->callback = callback;
+    request->user = user;
+
+    if (_glfw.wl.dataSource || !_glfw.wl.dataOffer)
+    {
+        // Answer the request from our own string, as the data source handler
+        // would block writing it to a pipe no one is reading yet, or fail it
+        // if there is nothing to paste, but still call the callback from
+        // within the event processing functions
+        if (_glfw.wl.dataSource && _glfw.wl.clipboardSendString)
+            request->data = _glfw_strdup(_glfw.wl.clipboardSendString);
+
+        _glfwPlatformPostEmptyEvent();
+        return;
+    }
+
+    if (pipe2(fds, O_CLOEXEC) < 0)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "Wayland: Impossible to create clipboard pipe fds");
+        _glfw.wl.clipboardRequests.count--;
+        return;
+    }
+
+    // NOTE: The read end is polled by the event processing functions along
+    //       with the display, so a slow source never blocks them
+    if (!_glfwPlatformAddWaitFd(fds[0]))
+    {
+        close(fds[0]);
+        close(fds[1]);
+        _glfw.wl.clipboardRequests.count--;
+        return;
+    }
+
+    request->fd = fds[0];
+
+    wl_data_offer_receive(_glfw.wl.dataOffer, "text/plain;charset=utf-8", fds[1]);
+    close(fds[1]);
+    wl_display_flush(_glfw.wl.display);
+}
+
+GLFWbool _glfwPlatformGetClipboardDataStream(const char* mime,
+                                             GLFWclipboarddatafun callback,
+                                             void* user)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Wayland: Streaming clipboard retrieval is not supported");
+    return GLFW_FALSE;
+}
+
+void _glfwPlatformSetClipboardDataSource(const char* mime,
+                                         size_t size,
+                                         GLFWclipboardsourcefun callback,
+                                         void* user)
+{
+    _glfwInputError(GLFW_PLATFORM_ERROR,
+                    "Wayland: Clipboard data sources are not supported");
+}
+
 void _glfwPlatformGetRequiredInstanceExtensions(char** extensions)
 {
     if (!_glfw.vk.KHR_surface || !_glfw.vk.KHR_wayland_surface)
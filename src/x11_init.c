@@ -36,6 +36,9 @@
 #include <limits.h>
 #include <stdio.h>
 #include <locale.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
 
 
 // Translate the X11 KeySyms for a key to a GLFW key code
@@ -460,10 +463,8 @@ static GLFWbool hasUsableInputMethodStyle(void)
 //
 static Atom getAtomIfSupported(Atom* supportedAtoms,
                                unsigned long atomCount,
-                               const char* atomName)
+                               Atom atom)
 {
-    const Atom atom = XInternAtom(_glfw.x11.display, atomName, False);
-
     for (unsigned long i = 0;  i < atomCount;  i++)
     {
         if (supportedAtoms[i] == atom)
@@ -473,9 +474,9 @@ static Atom getAtomIfSupported(Atom* supportedAtoms,
     return None;
 }
 
-// Check whether the running window manager is EWMH-compliant
+// Check whether an EWMH-compliant WM is currently running
 //
-static void detectEWMH(void)
+static GLFWbool isEWMHCompliant(void)
 {
     // First we read the _NET_SUPPORTING_WM_CHECK property on the root window
 
@@ -485,7 +486,7 @@ static void detectEWMH(void)
                                    XA_WINDOW,
                                    (unsigned char**) &windowFromRoot))
     {
-        return;
+        return GLFW_FALSE;
     }
 
     _glfwGrabErrorHandlerX11();
@@ -494,128 +495,78 @@ static void detectEWMH(void)
     // Then we look for the same property on that window
 
     Window* windowFromChild = NULL;
-    if (!_glfwGetWindowPropertyX11(*windowFromRoot,
-                                   _glfw.x11.NET_SUPPORTING_WM_CHECK,
-                                   XA_WINDOW,
-                                   (unsigned char**) &windowFromChild))
-    {
-        XFree(windowFromRoot);
-        return;
-    }
+    const unsigned long count =
+        _glfwGetWindowPropertyX11(*windowFromRoot,
+                                  _glfw.x11.NET_SUPPORTING_WM_CHECK,
+                                  XA_WINDOW,
+                                  (unsigned char**) &windowFromChild);
 
     _glfwReleaseErrorHandlerX11();
 
     // If the property exists, it should contain the XID of the window
 
-    if (*windowFromRoot != *windowFromChild)
-    {
-        XFree(windowFromRoot);
-        XFree(windowFromChild);
-        return;
-    }
+    const GLFWbool result = _glfw.x11.errorCode == Success &&
+                            count && windowFromChild &&
+                            *windowFromRoot == *windowFromChild;
 
     XFree(windowFromRoot);
-    XFree(windowFromChild);
+    if (_glfw.x11.errorCode == Success && windowFromChild)
+        XFree(windowFromChild);
 
-    // We are now fairly sure that an EWMH-compliant WM is currently running
-    // We can now start querying the WM about what features it supports by
-    // looking in the _NET_SUPPORTED property on the root window
-    // It should contain a list of supported EWMH protocol and state atoms
+    return result;
+}
 
+// Clear the EWMH atoms not supported by the running window manager
+//
+static void detectEWMH(void)
+{
     Atom* supportedAtoms = NULL;
-    const unsigned long atomCount =
-        _glfwGetWindowPropertyX11(_glfw.x11.root,
-                                  _glfw.x11.NET_SUPPORTED,
-                                  XA_ATOM,
-                                  (unsigned char**) &supportedAtoms);
+    unsigned long atomCount = 0;
+
+    // If an EWMH-compliant WM is running, we can query it about what features
+    // it supports by looking in the _NET_SUPPORTED property on the root window
+    // It should contain a list of supported EWMH protocol and state atoms
+
+    if (isEWMHCompliant())
+    {
+        atomCount = _glfwGetWindowPropertyX11(_glfw.x11.root,
+                                              _glfw.x11.NET_SUPPORTED,
+                                              XA_ATOM,
+                                              (unsigned char**) &supportedAtoms);
+    }
 
     // See which of the atoms we support that are supported by the WM
 
-    _glfw.x11.NET_WM_STATE =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_WM_STATE");
-    _glfw.x11.NET_WM_STATE_ABOVE =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_WM_STATE_ABOVE");
-    _glfw.x11.NET_WM_STATE_FULLSCREEN =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_WM_STATE_FULLSCREEN");
-    _glfw.x11.NET_WM_STATE_MAXIMIZED_VERT =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_WM_STATE_MAXIMIZED_VERT");
-    _glfw.x11.NET_WM_STATE_MAXIMIZED_HORZ =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_WM_STATE_MAXIMIZED_HORZ");
-    _glfw.x11.NET_WM_STATE_DEMANDS_ATTENTION =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_WM_STATE_DEMANDS_ATTENTION");
-    _glfw.x11.NET_WM_FULLSCREEN_MONITORS =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_WM_FULLSCREEN_MONITORS");
-    _glfw.x11.NET_WM_WINDOW_TYPE =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_WM_WINDOW_TYPE");
-    _glfw.x11.NET_WM_WINDOW_TYPE_NORMAL =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_WM_WINDOW_TYPE_NORMAL");
-    _glfw.x11.NET_WORKAREA =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_WORKAREA");
-    _glfw.x11.NET_CURRENT_DESKTOP =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_CURRENT_DESKTOP");
-    _glfw.x11.NET_ACTIVE_WINDOW =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_ACTIVE_WINDOW");
-    _glfw.x11.NET_FRAME_EXTENTS =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_FRAME_EXTENTS");
-    _glfw.x11.NET_REQUEST_FRAME_EXTENTS =
-        getAtomIfSupported(supportedAtoms, atomCount, "_NET_REQUEST_FRAME_EXTENTS");
+    Atom* atoms[] =
+    {
+        &_glfw.x11.NET_WM_STATE,
+        &_glfw.x11.NET_WM_STATE_ABOVE,
+        &_glfw.x11.NET_WM_STATE_FULLSCREEN,
+        &_glfw.x11.NET_WM_STATE_MAXIMIZED_VERT,
+        &_glfw.x11.NET_WM_STATE_MAXIMIZED_HORZ,
+        &_glfw.x11.NET_WM_STATE_DEMANDS_ATTENTION,
+        &_glfw.x11.NET_WM_FULLSCREEN_MONITORS,
+        &_glfw.x11.NET_WM_WINDOW_TYPE,
+        &_glfw.x11.NET_WM_WINDOW_TYPE_NORMAL,
+        &_glfw.x11.NET_WORKAREA,
+        &_glfw.x11.NET_CURRENT_DESKTOP,
+        &_glfw.x11.NET_ACTIVE_WINDOW,
+        &_glfw.x11.NET_FRAME_EXTENTS,
+        &_glfw.x11.NET_REQUEST_FRAME_EXTENTS
+    };
+
+    for (size_t i = 0;  i < sizeof(atoms) / sizeof(atoms[0]);  i++)
+        *atoms[i] = getAtomIfSupported(supportedAtoms, atomCount, *atoms[i]);
 
     if (supportedAtoms)
         XFree(supportedAtoms);
 }
 
-// Look for and initialize supported X11 extensions
+// Look for and initialize the X11 extensions that cannot be loaded on first use
+// NOTE: The remaining extensions are loaded on first use by _glfwLoad*X11
 //
 static GLFWbool initExtensions(void)
 {
-    _glfw.x11.vidmode.handle = _glfw_dlopen("libXxf86vm.so.1");
-    if (_glfw.x11.vidmode.handle)
-    {
-        _glfw.x11.vidmode.QueryExtension = (PFN_XF86VidModeQueryExtension)
-            _glfw_dlsym(_glfw.x11.vidmode.handle, "XF86VidModeQueryExtension");
-        _glfw.x11.vidmode.GetGammaRamp = (PFN_XF86VidModeGetGammaRamp)
-            _glfw_dlsym(_glfw.x11.vidmode.handle, "XF86VidModeGetGammaRamp");
-        _glfw.x11.vidmode.SetGammaRamp = (PFN_XF86VidModeSetGammaRamp)
-            _glfw_dlsym(_glfw.x11.vidmode.handle, "XF86VidModeSetGammaRamp");
-        _glfw.x11.vidmode.GetGammaRampSize = (PFN_XF86VidModeGetGammaRampSize)
-            _glfw_dlsym(_glfw.x11.vidmode.handle, "XF86VidModeGetGammaRampSize");
-
-        _glfw.x11.vidmode.available =
-            XF86VidModeQueryExtension(_glfw.x11.display,
-                                      &_glfw.x11.vidmode.eventBase,
-                                      &_glfw.x11.vidmode.errorBase);
-    }
-
-#if defined(__CYGWIN__)
-    _glfw.x11.xi.handle = _glfw_dlopen("libXi-6.so");
-#else
-    _glfw.x11.xi.handle = _glfw_dlopen("libXi.so.6");
-#endif
-    if (_glfw.x11.xi.handle)
-    {
-        _glfw.x11.xi.QueryVersion = (PFN_XIQueryVersion)
-            _glfw_dlsym(_glfw.x11.xi.handle, "XIQueryVersion");
-        _glfw.x11.xi.SelectEvents = (PFN_XISelectEvents)
-            _glfw_dlsym(_glfw.x11.xi.handle, "XISelectEvents");
-
-        if (XQueryExtension(_glfw.x11.display,
-                            "XInputExtension",
-                            &_glfw.x11.xi.majorOpcode,
-                            &_glfw.x11.xi.eventBase,
-                            &_glfw.x11.xi.errorBase))
-        {
-            _glfw.x11.xi.major = 2;
-            _glfw.x11.xi.minor = 0;
-
-            if (XIQueryVersion(_glfw.x11.display,
-                               &_glfw.x11.xi.major,
-                               &_glfw.x11.xi.minor) == Success)
-            {
-                _glfw.x11.xi.available = GLFW_TRUE;
-            }
-        }
-    }
-
 #if defined(__CYGWIN__)
     _glfw.x11.randr.handle = _glfw_dlopen("libXrandr-2.so");
 #else
@@ -705,45 +656,7 @@ static GLFWbool initExtensions(void)
     if (_glfw.x11.randr.available && !_glfw.x11.randr.monitorBroken)
     {
         XRRSelectInput(_glfw.x11.display, _glfw.x11.root,
-                       RROutputChangeNotifyMask);
-    }
-
-#if defined(__CYGWIN__)
-    _glfw.x11.xcursor.handle = _glfw_dlopen("libXcursor-1.so");
-#else
-    _glfw.x11.xcursor.handle = _glfw_dlopen("libXcursor.so.1");
-#endif
-    if (_glfw.x11.xcursor.handle)
-    {
-        _glfw.x11.xcursor.ImageCreate = (PFN_XcursorImageCreate)
-            _glfw_dlsym(_glfw.x11.xcursor.handle, "XcursorImageCreate");
-        _glfw.x11.xcursor.ImageDestroy = (PFN_XcursorImageDestroy)
-            _glfw_dlsym(_glfw.x11.xcursor.handle, "XcursorImageDestroy");
-        _glfw.x11.xcursor.ImageLoadCursor = (PFN_XcursorImageLoadCursor)
-            _glfw_dlsym(_glfw.x11.xcursor.handle, "XcursorImageLoadCursor");
-    }
-
-#if defined(__CYGWIN__)
-    _glfw.x11.xinerama.handle = _glfw_dlopen("libXinerama-1.so");
-#else
-    _glfw.x11.xinerama.handle = _glfw_dlopen("libXinerama.so.1");
-#endif
-    if (_glfw.x11.xinerama.handle)
-    {
-        _glfw.x11.xinerama.IsActive = (PFN_XineramaIsActive)
-            _glfw_dlsym(_glfw.x11.xinerama.handle, "XineramaIsActive");
-        _glfw.x11.xinerama.QueryExtension = (PFN_XineramaQueryExtension)
-            _glfw_dlsym(_glfw.x11.xinerama.handle, "XineramaQueryExtension");
-        _glfw.x11.xinerama.QueryScreens = (PFN_XineramaQueryScreens)
-            _glfw_dlsym(_glfw.x11.xinerama.handle, "XineramaQueryScreens");
-
-        if (XineramaQueryExtension(_glfw.x11.display,
-                                   &_glfw.x11.xinerama.major,
-                                   &_glfw.x11.xinerama.minor))
-        {
-            if (XineramaIsActive(_glfw.x11.display))
-                _glfw.x11.xinerama.available = GLFW_TRUE;
-        }
+                       RROutputChangeNotifyMask | RRScreenChangeNotifyMask);
     }
 
     _glfw.x11.xkb.major = 1;
@@ -774,6 +687,8 @@ static GLFWbool initExtensions(void)
                               XkbGroupStateMask, XkbGroupStateMask);
     }
 
+    // NOTE: X11-xcb is loaded here rather than on first use as the Vulkan
+    //       functions needing it may be called from any thread
 #if defined(__CYGWIN__)
     _glfw.x11.x11xcb.handle = _glfw_dlopen("libX11-xcb-1.so");
 #else
@@ -785,109 +700,107 @@ static GLFWbool initExtensions(void)
             _glfw_dlsym(_glfw.x11.x11xcb.handle, "XGetXCBConnection");
     }
 
-#if defined(__CYGWIN__)
-    _glfw.x11.xrender.handle = _glfw_dlopen("libXrender-1.so");
-#else
-    _glfw.x11.xrender.handle = _glfw_dlopen("libXrender.so.1");
-#endif
-    if (_glfw.x11.xrender.handle)
-    {
-        _glfw.x11.xrender.QueryExtension = (PFN_XRenderQueryExtension)
-            _glfw_dlsym(_glfw.x11.xrender.handle, "XRenderQueryExtension");
-        _glfw.x11.xrender.QueryVersion = (PFN_XRenderQueryVersion)
-            _glfw_dlsym(_glfw.x11.xrender.handle, "XRenderQueryVersion");
-        _glfw.x11.xrender.FindVisualFormat = (PFN_XRenderFindVisualFormat)
-            _glfw_dlsym(_glfw.x11.xrender.handle, "XRenderFindVisualFormat");
-
-        if (XRenderQueryExtension(_glfw.x11.display,
-                                  &_glfw.x11.xrender.errorBase,
-                                  &_glfw.x11.xrender.eventBase))
-        {
-            if (XRenderQueryVersion(_glfw.x11.display,
-                                    &_glfw.x11.xrender.major,
-                                    &_glfw.x11.xrender.minor))
-            {
-                _glfw.x11.xrender.available = GLFW_TRUE;
-            }
-        }
-    }
-
     // Update the key code LUT
     // FIXME: We should listen to XkbMapNotify events to track changes to
     // the keyboard mapping.
     createKeyTables();
 
-    // String format atoms
-    _glfw.x11.NULL_ = XInternAtom(_glfw.x11.display, "NULL", False);
-    _glfw.x11.UTF8_STRING = XInternAtom(_glfw.x11.display, "UTF8_STRING", False);
-    _glfw.x11.ATOM_PAIR = XInternAtom(_glfw.x11.display, "ATOM_PAIR", False);
-
-    // Custom selection property atom
-    _glfw.x11.GLFW_SELECTION =
-        XInternAtom(_glfw.x11.display, "GLFW_SELECTION", False);
-
-    // ICCCM standard clipboard atoms
-    _glfw.x11.TARGETS = XInternAtom(_glfw.x11.display, "TARGETS", False);
-    _glfw.x11.MULTIPLE = XInternAtom(_glfw.x11.display, "MULTIPLE", False);
-    _glfw.x11.PRIMARY = XInternAtom(_glfw.x11.display, "PRIMARY", False);
-    _glfw.x11.INCR = XInternAtom(_glfw.x11.display, "INCR", False);
-    _glfw.x11.CLIPBOARD = XInternAtom(_glfw.x11.display, "CLIPBOARD", False);
-
-    // Clipboard manager atoms
-    _glfw.x11.CLIPBOARD_MANAGER =
-        XInternAtom(_glfw.x11.display, "CLIPBOARD_MANAGER", False);
-    _glfw.x11.SAVE_TARGETS =
-        XInternAtom(_glfw.x11.display, "SAVE_TARGETS", False);
-
-    // Xdnd (drag and drop) atoms
-    _glfw.x11.XdndAware = XInternAtom(_glfw.x11.display, "XdndAware", False);
-    _glfw.x11.XdndEnter = XInternAtom(_glfw.x11.display, "XdndEnter", False);
-    _glfw.x11.XdndPosition = XInternAtom(_glfw.x11.display, "XdndPosition", False);
-    _glfw.x11.XdndStatus = XInternAtom(_glfw.x11.display, "XdndStatus", False);
-    _glfw.x11.XdndActionCopy = XInternAtom(_glfw.x11.display, "XdndActionCopy", False);
-    _glfw.x11.XdndDrop = XInternAtom(_glfw.x11.display, "XdndDrop", False);
-    _glfw.x11.XdndFinished = XInternAtom(_glfw.x11.display, "XdndFinished", False);
-    _glfw.x11.XdndSelection = XInternAtom(_glfw.x11.display, "XdndSelection", False);
-    _glfw.x11.XdndTypeList = XInternAtom(_glfw.x11.display, "XdndTypeList", False);
-    _glfw.x11.text_uri_list = XInternAtom(_glfw.x11.display, "text/uri-list", False);
-
-    // ICCCM, EWMH and Motif window property atoms
-    // These can be set safely even without WM support
-    // The EWMH atoms that require WM support are handled in detectEWMH
-    _glfw.x11.WM_PROTOCOLS =
-        XInternAtom(_glfw.x11.display, "WM_PROTOCOLS", False);
-    _glfw.x11.WM_STATE =
-        XInternAtom(_glfw.x11.display, "WM_STATE", False);
-    _glfw.x11.WM_DELETE_WINDOW =
-        XInternAtom(_glfw.x11.display, "WM_DELETE_WINDOW", False);
-    _glfw.x11.NET_SUPPORTED =
-        XInternAtom(_glfw.x11.display, "_NET_SUPPORTED", False);
-    _glfw.x11.NET_SUPPORTING_WM_CHECK =
-        XInternAtom(_glfw.x11.display, "_NET_SUPPORTING_WM_CHECK", False);
-    _glfw.x11.NET_WM_ICON =
-        XInternAtom(_glfw.x11.display, "_NET_WM_ICON", False);
-    _glfw.x11.NET_WM_PING =
-        XInternAtom(_glfw.x11.display, "_NET_WM_PING", False);
-    _glfw.x11.NET_WM_PID =
-        XInternAtom(_glfw.x11.display, "_NET_WM_PID", False);
-    _glfw.x11.NET_WM_NAME =
-        XInternAtom(_glfw.x11.display, "_NET_WM_NAME", False);
-    _glfw.x11.NET_WM_ICON_NAME =
-        XInternAtom(_glfw.x11.display, "_NET_WM_ICON_NAME", False);
-    _glfw.x11.NET_WM_BYPASS_COMPOSITOR =
-        XInternAtom(_glfw.x11.display, "_NET_WM_BYPASS_COMPOSITOR", False);
-    _glfw.x11.NET_WM_WINDOW_OPACITY =
-        XInternAtom(_glfw.x11.display, "_NET_WM_WINDOW_OPACITY", False);
-    _glfw.x11.MOTIF_WM_HINTS =
-        XInternAtom(_glfw.x11.display, "_MOTIF_WM_HINTS", False);
-
     // The compositing manager selection name contains the screen number
+    char cmName[32];
+    snprintf(cmName, sizeof(cmName), "_NET_WM_CM_S%u", _glfw.x11.screen);
+
+    // NOTE: All atoms are interned with a single batch of requests, as
+    //       interning them one at a time costs a round-trip each
+    const struct
+    {
+        char* name;
+        Atom* atom;
+    } atoms[] =
     {
-        char name[32];
-        snprintf(name, sizeof(name), "_NET_WM_CM_S%u", _glfw.x11.screen);
-        _glfw.x11.NET_WM_CM_Sx = XInternAtom(_glfw.x11.display, name, False);
+        // String format atoms
+        { "NULL", &_glfw.x11.NULL_ },
+        { "UTF8_STRING", &_glfw.x11.UTF8_STRING },
+        { "text/plain", &_glfw.x11.text_plain },
+        { "text/plain;charset=utf-8", &_glfw.x11.text_plain_utf8 },
+        { "ATOM_PAIR", &_glfw.x11.ATOM_PAIR },
+
+        // Custom selection property atom
+        { "GLFW_SELECTION", &_glfw.x11.GLFW_SELECTION },
+
+        // ICCCM standard clipboard atoms
+        { "TARGETS", &_glfw.x11.TARGETS },
+        { "MULTIPLE", &_glfw.x11.MULTIPLE },
+        { "PRIMARY", &_glfw.x11.PRIMARY },
+        { "INCR", &_glfw.x11.INCR },
+        { "CLIPBOARD", &_glfw.x11.CLIPBOARD },
+
+        // Clipboard manager atoms
+        { "CLIPBOARD_MANAGER", &_glfw.x11.CLIPBOARD_MANAGER },
+        { "SAVE_TARGETS", &_glfw.x11.SAVE_TARGETS },
+
+        // Xdnd (drag and drop) atoms
+        { "XdndAware", &_glfw.x11.XdndAware },
+        { "XdndEnter", &_glfw.x11.XdndEnter },
+        { "XdndPosition", &_glfw.x11.XdndPosition },
+        { "XdndStatus", &_glfw.x11.XdndStatus },
+        { "XdndActionCopy", &_glfw.x11.XdndActionCopy },
+        { "XdndDrop", &_glfw.x11.XdndDrop },
+        { "XdndFinished", &_glfw.x11.XdndFinished },
+        { "XdndSelection", &_glfw.x11.XdndSelection },
+        { "XdndTypeList", &_glfw.x11.XdndTypeList },
+        { "text/uri-list", &_glfw.x11.text_uri_list },
+
+        // ICCCM, EWMH and Motif window property atoms
+        // These can be set safely even without WM support
+        { "WM_PROTOCOLS", &_glfw.x11.WM_PROTOCOLS },
+        { "WM_STATE", &_glfw.x11.WM_STATE },
+        { "WM_DELETE_WINDOW", &_glfw.x11.WM_DELETE_WINDOW },
+        { "_NET_SUPPORTED", &_glfw.x11.NET_SUPPORTED },
+        { "_NET_SUPPORTING_WM_CHECK", &_glfw.x11.NET_SUPPORTING_WM_CHECK },
+        { "_NET_WM_ICON", &_glfw.x11.NET_WM_ICON },
+        { "_NET_WM_PING", &_glfw.x11.NET_WM_PING },
+        { "_NET_WM_PID", &_glfw.x11.NET_WM_PID },
+        { "_NET_WM_NAME", &_glfw.x11.NET_WM_NAME },
+        { "_NET_WM_ICON_NAME", &_glfw.x11.NET_WM_ICON_NAME },
+        { "_NET_WM_BYPASS_COMPOSITOR", &_glfw.x11.NET_WM_BYPASS_COMPOSITOR },
+        { "_NET_WM_WINDOW_OPACITY", &_glfw.x11.NET_WM_WINDOW_OPACITY },
+        { "_MOTIF_WM_HINTS", &_glfw.x11.MOTIF_WM_HINTS },
+        { cmName, &_glfw.x11.NET_WM_CM_Sx },
+
+        // EWMH atoms that require WM support
+        // These are cleared by detectEWMH if the WM does not support them
+        { "_NET_WM_STATE", &_glfw.x11.NET_WM_STATE },
+        { "_NET_WM_STATE_ABOVE", &_glfw.x11.NET_WM_STATE_ABOVE },
+        { "_NET_WM_STATE_FULLSCREEN", &_glfw.x11.NET_WM_STATE_FULLSCREEN },
+        { "_NET_WM_STATE_MAXIMIZED_VERT", &_glfw.x11.NET_WM_STATE_MAXIMIZED_VERT },
+        { "_NET_WM_STATE_MAXIMIZED_HORZ", &_glfw.x11.NET_WM_STATE_MAXIMIZED_HORZ },
+        { "_NET_WM_STATE_DEMANDS_ATTENTION", &_glfw.x11.NET_WM_STATE_DEMANDS_ATTENTION },
+        { "_NET_WM_FULLSCREEN_MONITORS", &_glfw.x11.NET_WM_FULLSCREEN_MONITORS },
+        { "_NET_WM_WINDOW_TYPE", &_glfw.x11.NET_WM_WINDOW_TYPE },
+        { "_NET_WM_WINDOW_TYPE_NORMAL", &_glfw.x11.NET_WM_WINDOW_TYPE_NORMAL },
+        { "_NET_WORKAREA", &_glfw.x11.NET_WORKAREA },
+        { "_NET_CURRENT_DESKTOP", &_glfw.x11.NET_CURRENT_DESKTOP },
+        { "_NET_ACTIVE_WINDOW", &_glfw.x11.NET_ACTIVE_WINDOW },
+        { "_NET_FRAME_EXTENTS", &_glfw.x11.NET_FRAME_EXTENTS },
+        { "_NET_REQUEST_FRAME_EXTENTS", &_glfw.x11.NET_REQUEST_FRAME_EXTENTS }
+    };
+
+    const int atomCount = sizeof(atoms) / sizeof(atoms[0]);
+    char* names[sizeof(atoms) / sizeof(atoms[0])];
+    Atom values[sizeof(atoms) / sizeof(atoms[0])];
+
+    for (int i = 0;  i < atomCount;  i++)
+        names[i] = atoms[i].name;
+
+    if (!XInternAtoms(_glfw.x11.display, names, atomCount, False, values))
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR, "X11: Failed to intern atoms");
+        return GLFW_FALSE;
     }
 
+    for (int i = 0;  i < atomCount;  i++)
+        *atoms[i].atom = values[i];
+
     // Detect whether an EWMH-conformant window manager is running
     detectEWMH();
 
@@ -933,9 +846,19 @@ static void getSystemContentScale(float* xscale, float* yscale)
 //
 static Cursor createHiddenCursor(void)
 {
-    unsigned char pixels[16 * 16 * 4] = { 0 };
-    GLFWimage image = { 16, 16, pixels };
-    return _glfwCreateCursorX11(&image, 0, 0);
+    // NOTE: A core cursor with an empty mask is invisible and does not need
+    //       the Xcursor library to be loaded during initialization
+    char data = 0;
+    XColor color = { 0 };
+
+    const Pixmap pixmap = XCreateBitmapFromData(_glfw.x11.display,
+                                                _glfw.x11.root,
+                                                &data, 1, 1);
+    const Cursor cursor = XCreatePixmapCursor(_glfw.x11.display,
+                                              pixmap, pixmap,
+                                              &color, &color, 0, 0);
+    XFreePixmap(_glfw.x11.display, pixmap);
+    return cursor;
 }
 
 // Create a helper window for IPC
@@ -952,6 +875,89 @@ static Window createHelperWindow(void)
                          CWEventMask, &wa);
 }
 
+// Create a non-blocking pipe for waking up a thread waiting on it
+//
+static GLFWbool createPipe(int fds[2])
+{
+    int i;
+
+    if (pipe(fds) != 0)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "X11: Failed to create pipe: %s",
+                        strerror(errno));
+        return GLFW_FALSE;
+    }
+
+    for (i = 0;  i < 2;  i++)
+    {
+        const int sf = fcntl(fds[i], F_GETFL, 0);
+        const int df = fcntl(fds[i], F_GETFD, 0);
+
+        if (sf == -1 || df == -1 ||
+            fcntl(fds[i], F_SETFL, sf | O_NONBLOCK) == -1 ||
+            fcntl(fds[i], F_SETFD, df | FD_CLOEXEC) == -1)
+        {
+            _glfwInputError(GLFW_PLATFORM_ERROR,
+                            "X11: Failed to set flags for pipe: %s",
+                            strerror(errno));
+            return GLFW_FALSE;
+        }
+    }
+
+    return GLFW_TRUE;
+}
+
+// Close a pipe created by createPipe
+//
+static void closePipe(int fds[2])
+{
+    if (fds[0] || fds[1])
+    {
+        close(fds[0]);
+        close(fds[1]);
+    }
+}
+
+// Create the set of descriptors waited on for events
+//
+static GLFWbool createPollSet(void)
+{
+    int i;
+
+    _glfw.x11.pollfds = calloc(_GLFW_X11_POLL_COUNT, sizeof(struct pollfd));
+    if (!_glfw.x11.pollfds)
+    {
+        _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+        return GLFW_FALSE;
+    }
+
+    _glfw.x11.pollfdCount = _GLFW_X11_POLL_COUNT;
+
+    // NOTE: Unused entries are negative and ignored by poll
+    for (i = 0;  i < _GLFW_X11_POLL_COUNT;  i++)
+    {
+        _glfw.x11.pollfds[i].fd = -1;
+        _glfw.x11.pollfds[i].events = POLLIN;
+    }
+
+    _glfw.x11.pollfds[_GLFW_X11_POLL_DISPLAY].fd =
+        ConnectionNumber(_glfw.x11.display);
+#if defined(__linux__)
+    if (_glfw.linjs.inotify > 0)
+        _glfw.x11.pollfds[_GLFW_X11_POLL_INOTIFY].fd = _glfw.linjs.inotify;
+#endif
+    if (_glfw.x11.eventThread.running)
+    {
+        _glfw.x11.pollfds[_GLFW_X11_POLL_WAKE].fd =
+            _glfw.x11.eventThread.wakePipe[0];
+    }
+    _glfw.x11.pollfds[_GLFW_X11_POLL_EMPTY_EVENT].fd =
+        _glfw.x11.emptyEventPipe[0];
+
+    return GLFW_TRUE;
+}
+
 // X error handler
 //
 static int errorHandler(Display *display, XErrorEvent* event)
@@ -996,6 +1002,261 @@ void _glfwInputErrorX11(int error, const char* message)
     _glfwInputError(error, "%s: %s", message, buffer);
 }
 
+// Loads the XFree86 VidMode library and queries the extension on first use
+//
+GLFWbool _glfwLoadVidmodeX11(void)
+{
+    if (_glfw.x11.vidmode.loaded)
+        return _glfw.x11.vidmode.available;
+
+    _glfw.x11.vidmode.loaded = GLFW_TRUE;
+
+    _glfw.x11.vidmode.handle = _glfw_dlopen("libXxf86vm.so.1");
+    if (_glfw.x11.vidmode.handle)
+    {
+        _glfw.x11.vidmode.QueryExtension = (PFN_XF86VidModeQueryExtension)
+            _glfw_dlsym(_glfw.x11.vidmode.handle, "XF86VidModeQueryExtension");
+        _glfw.x11.vidmode.GetGammaRamp = (PFN_XF86VidModeGetGammaRamp)
+            _glfw_dlsym(_glfw.x11.vidmode.handle, "XF86VidModeGetGammaRamp");
+        _glfw.x11.vidmode.SetGammaRamp = (PFN_XF86VidModeSetGammaRamp)
+            _glfw_dlsym(_glfw.x11.vidmode.handle, "XF86VidModeSetGammaRamp");
+        _glfw.x11.vidmode.GetGammaRampSize = (PFN_XF86VidModeGetGammaRampSize)
+            _glfw_dlsym(_glfw.x11.vidmode.handle, "XF86VidModeGetGammaRampSize");
+
+        _glfw.x11.vidmode.available =
+            XF86VidModeQueryExtension(_glfw.x11.display,
+                                      &_glfw.x11.vidmode.eventBase,
+                                      &_glfw.x11.vidmode.errorBase);
+    }
+
+    return _glfw.x11.vidmode.available;
+}
+
+// Loads the XInput library and queries the XInput2 extension on first use
+//
+GLFWbool _glfwLoadXiX11(void)
+{
+    if (_glfw.x11.xi.loaded)
+        return _glfw.x11.xi.available;
+
+    _glfw.x11.xi.loaded = GLFW_TRUE;
+
+#if defined(__CYGWIN__)
+    _glfw.x11.xi.handle = _glfw_dlopen("libXi-6.so");
+#else
+    _glfw.x11.xi.handle = _glfw_dlopen("libXi.so.6");
+#endif
+    if (_glfw.x11.xi.handle)
+    {
+        _glfw.x11.xi.QueryVersion = (PFN_XIQueryVersion)
+            _glfw_dlsym(_glfw.x11.xi.handle, "XIQueryVersion");
+        _glfw.x11.xi.SelectEvents = (PFN_XISelectEvents)
+            _glfw_dlsym(_glfw.x11.xi.handle, "XISelectEvents");
+
+        if (XQueryExtension(_glfw.x11.display,
+                            "XInputExtension",
+                            &_glfw.x11.xi.majorOpcode,
+                            &_glfw.x11.xi.eventBase,
+                            &_glfw.x11.xi.errorBase))
+        {
+            _glfw.x11.xi.major = 2;
+            _glfw.x11.xi.minor = 0;
+
+            if (XIQueryVersion(_glfw.x11.display,
+                               &_glfw.x11.xi.major,
+                               &_glfw.x11.xi.minor) == Success)
+            {
+                _glfw.x11.xi.available = GLFW_TRUE;
+            }
+        }
+    }
+
+    return _glfw.x11.xi.available;
+}
+
+// Loads the Xcursor library on first use
+//
+GLFWbool _glfwLoadXcursorX11(void)
+{
+    if (_glfw.x11.xcursor.loaded)
+        return _glfw.x11.xcursor.handle != NULL;
+
+    _glfw.x11.xcursor.loaded = GLFW_TRUE;
+
+#if defined(__CYGWIN__)
+    _glfw.x11.xcursor.handle = _glfw_dlopen("libXcursor-1.so");
+#else
+    _glfw.x11.xcursor.handle = _glfw_dlopen("libXcursor.so.1");
+#endif
+    if (_glfw.x11.xcursor.handle)
+    {
+        _glfw.x11.xcursor.ImageCreate = (PFN_XcursorImageCreate)
+            _glfw_dlsym(_glfw.x11.xcursor.handle, "XcursorImageCreate");
+        _glfw.x11.xcursor.ImageDestroy = (PFN_XcursorImageDestroy)
+            _glfw_dlsym(_glfw.x11.xcursor.handle, "XcursorImageDestroy");
+        _glfw.x11.xcursor.ImageLoadCursor = (PFN_XcursorImageLoadCursor)
+            _glfw_dlsym(_glfw.x11.xcursor.handle, "XcursorImageLoadCursor");
+    }
+
+    return _glfw.x11.xcursor.handle != NULL;
+}
+
+// Loads the Xinerama library and queries the extension on first use
+//
+GLFWbool _glfwLoadXineramaX11(void)
+{
+    if (_glfw.x11.xinerama.loaded)
+        return _glfw.x11.xinerama.available;
+
+    _glfw.x11.xinerama.loaded = GLFW_TRUE;
+
+#if defined(__CYGWIN__)
+    _glfw.x11.xinerama.handle = _glfw_dlopen("libXinerama-1.so");
+#else
+    _glfw.x11.xinerama.handle = _glfw_dlopen("libXinerama.so.1");
+#endif
+    if (_glfw.x11.xinerama.handle)
+    {
+        _glfw.x11.xinerama.IsActive = (PFN_XineramaIsActive)
+            _glfw_dlsym(_glfw.x11.xinerama.handle, "XineramaIsActive");
+        _glfw.x11.xinerama.QueryExtension = (PFN_XineramaQueryExtension)
+            _glfw_dlsym(_glfw.x11.xinerama.handle, "XineramaQueryExtension");
+        _glfw.x11.xinerama.QueryScreens = (PFN_XineramaQueryScreens)
+            _glfw_dlsym(_glfw.x11.xinerama.handle, "XineramaQueryScreens");
+
+        if (XineramaQueryExtension(_glfw.x11.display,
+                                   &_glfw.x11.xinerama.major,
+                                   &_glfw.x11.xinerama.minor))
+        {
+            if (XineramaIsActive(_glfw.x11.display))
+                _glfw.x11.xinerama.available = GLFW_TRUE;
+        }
+    }
+
+    return _glfw.x11.xinerama.available;
+}
+
+// Loads the Xrender library and queries the extension on first use
+//
+GLFWbool _glfwLoadXrenderX11(void)
+{
+    if (_glfw.x11.xrender.loaded)
+        return _glfw.x11.xrender.available;
+
+    _glfw.x11.xrender.loaded = GLFW_TRUE;
+
+#if defined(__CYGWIN__)
+    _glfw.x11.xrender.handle = _glfw_dlopen("libXrender-1.so");
+#else
+    _glfw.x11.xrender.handle = _glfw_dlopen("libXrender.so.1");
+#endif
+    if (_glfw.x11.xrender.handle)
+    {
+        _glfw.x11.xrender.QueryExtension = (PFN_XRenderQueryExtension)
+            _glfw_dlsym(_glfw.x11.xrender.handle, "XRenderQueryExtension");
+        _glfw.x11.xrender.QueryVersion = (PFN_XRenderQueryVersion)
+            _glfw_dlsym(_glfw.x11.xrender.handle, "XRenderQueryVersion");
+        _glfw.x11.xrender.FindVisualFormat = (PFN_XRenderFindVisualFormat)
+            _glfw_dlsym(_glfw.x11.xrender.handle, "XRenderFindVisualFormat");
+
+        if (XRenderQueryExtension(_glfw.x11.display,
+                                  &_glfw.x11.xrender.errorBase,
+                                  &_glfw.x11.xrender.eventBase))
+        {
+            if (XRenderQueryVersion(_glfw.x11.display,
+                                    &_glfw.x11.xrender.major,
+                                    &_glfw.x11.xrender.minor))
+            {
+                _glfw.x11.xrender.available = GLFW_TRUE;
+            }
+        }
+    }
+
+    return _glfw.x11.xrender.available;
+}
+
+// Loads the Xext library and queries the MIT-SHM extension on first use
+//
+GLFWbool _glfwLoadXshmX11(void)
+{
+    if (_glfw.x11.xshm.loaded)
+        return _glfw.x11.xshm.available;
+
+    _glfw.x11.xshm.loaded = GLFW_TRUE;
+
+#if defined(__CYGWIN__)
+    _glfw.x11.xshm.handle = _glfw_dlopen("libXext-6.so");
+#else
+    _glfw.x11.xshm.handle = _glfw_dlopen("libXext.so.6");
+#endif
+    if (_glfw.x11.xshm.handle)
+    {
+        _glfw.x11.xshm.QueryExtension = (PFN_XShmQueryExtension)
+            _glfw_dlsym(_glfw.x11.xshm.handle, "XShmQueryExtension");
+        _glfw.x11.xshm.GetEventBase = (PFN_XShmGetEventBase)
+            _glfw_dlsym(_glfw.x11.xshm.handle, "XShmGetEventBase");
+        _glfw.x11.xshm.Attach = (PFN_XShmAttach)
+            _glfw_dlsym(_glfw.x11.xshm.handle, "XShmAttach");
+        _glfw.x11.xshm.Detach = (PFN_XShmDetach)
+            _glfw_dlsym(_glfw.x11.xshm.handle, "XShmDetach");
+        _glfw.x11.xshm.CreateImage = (PFN_XShmCreateImage)
+            _glfw_dlsym(_glfw.x11.xshm.handle, "XShmCreateImage");
+        _glfw.x11.xshm.PutImage = (PFN_XShmPutImage)
+            _glfw_dlsym(_glfw.x11.xshm.handle, "XShmPutImage");
+
+        if (XShmQueryExtension(_glfw.x11.display))
+        {
+            _glfw.x11.xshm.eventBase = XShmGetEventBase(_glfw.x11.display);
+            _glfw.x11.xshm.available = GLFW_TRUE;
+        }
+    }
+
+    return _glfw.x11.xshm.available;
+}
+
+// Loads the Xpresent library and queries the Present extension on first use
+//
+GLFWbool _glfwLoadPresentX11(void)
+{
+    if (_glfw.x11.present.loaded)
+        return _glfw.x11.present.available;
+
+    _glfw.x11.present.loaded = GLFW_TRUE;
+
+#if defined(__CYGWIN__)
+    _glfw.x11.present.handle = _glfw_dlopen("libXpresent-1.so");
+#else
+    _glfw.x11.present.handle = _glfw_dlopen("libXpresent.so.1");
+#endif
+    if (_glfw.x11.present.handle)
+    {
+        _glfw.x11.present.QueryExtension = (PFN_XPresentQueryExtension)
+            _glfw_dlsym(_glfw.x11.present.handle, "XPresentQueryExtension");
+        _glfw.x11.present.QueryVersion = (PFN_XPresentQueryVersion)
+            _glfw_dlsym(_glfw.x11.present.handle, "XPresentQueryVersion");
+        _glfw.x11.present.SelectInput = (PFN_XPresentSelectInput)
+            _glfw_dlsym(_glfw.x11.present.handle, "XPresentSelectInput");
+
+        if (XPresentQueryExtension(_glfw.x11.display,
+                                   &_glfw.x11.present.majorOpcode,
+                                   &_glfw.x11.present.eventBase,
+                                   &_glfw.x11.present.errorBase))
+        {
+            _glfw.x11.present.major = 1;
+            _glfw.x11.present.minor = 0;
+
+            if (XPresentQueryVersion(_glfw.x11.display,
+                                     &_glfw.x11.present.major,
+                                     &_glfw.x11.present.minor))
+            {
+                _glfw.x11.present.available = GLFW_TRUE;
+            }
+        }
+    }
+
+    return _glfw.x11.present.available;
+}
+
 // Creates a native cursor object from the specified image and hotspot
 //
 Cursor _glfwCreateCursorX11(const GLFWimage* image, int xhot, int yhot)
@@ -1003,7 +1264,7 @@ Cursor _glfwCreateCursorX11(const GLFWimage* image, int xhot, int yhot)
     int i;
     Cursor cursor;
 
-    if (!_glfw.x11.xcursor.handle)
+    if (!_glfwLoadXcursorX11())
         return None;
 
     XcursorImage* native = XcursorImageCreate(image->width, image->height);
@@ -1069,13 +1330,15 @@ int _glfwPlatformInit(void)
 
     _glfw.x11.screen = DefaultScreen(_glfw.x11.display);
     _glfw.x11.root = RootWindow(_glfw.x11.display, _glfw.x11.screen);
-    _glfw.x11.context = XUniqueContext();
 
     getSystemContentScale(&_glfw.x11.contentScaleX, &_glfw.x11.contentScaleY);
 
     if (!initExtensions())
         return GLFW_FALSE;
 
+    if (!createPipe(_glfw.x11.emptyEventPipe))
+        return GLFW_FALSE;
+
     _glfw.x11.helperWindowHandle = createHelperWindow();
     _glfw.x11.hiddenCursorHandle = createHiddenCursor();
 
@@ -1102,11 +1365,30 @@ int _glfwPlatformInit(void)
     _glfwInitTimerPOSIX();
 
     _glfwPollMonitorsX11();
+
+    if (_glfw.hints.init.x11.eventThread)
+    {
+        if (!createPipe(_glfw.x11.eventThread.wakePipe) ||
+            !createPipe(_glfw.x11.eventThread.stopPipe))
+        {
+            return GLFW_FALSE;
+        }
+
+        if (!_glfwStartEventThreadX11())
+            return GLFW_FALSE;
+    }
+
+    if (!createPollSet())
+        return GLFW_FALSE;
+
     return GLFW_TRUE;
 }
 
 void _glfwPlatformTerminate(void)
 {
+    if (_glfw.x11.eventThread.running)
+        _glfwStopEventThreadX11();
+
     if (_glfw.x11.helperWindowHandle)
     {
         if (XGetSelectionOwner(_glfw.x11.display, _glfw.x11.CLIPBOARD) ==
@@ -1125,9 +1407,38 @@ void _glfwPlatformTerminate(void)
         _glfw.x11.hiddenCursorHandle = (Cursor) 0;
     }
 
+    for (int i = 0;  i < _GLFW_X11_IMAGE_CACHE_SIZE;  i++)
+    {
+        _GLFWiconcacheX11* icon = _glfw.x11.iconCache.entries + i;
+        _GLFWcursorcacheX11* cursor = _glfw.x11.cursorCache.entries + i;
+
+        free(icon->key.data);
+        free(icon->data);
+
+        free(cursor->key.data);
+        if (cursor->handle)
+            XFreeCursor(_glfw.x11.display, cursor->handle);
+    }
+
     free(_glfw.x11.primarySelectionString);
     free(_glfw.x11.clipboardString);
 
+    if (_glfw.x11.clipboardSource.callback)
+    {
+        _glfw.x11.clipboardSource.callback(NULL, 0, 0,
+                                           _glfw.x11.clipboardSource.user);
+    }
+
+    free(_glfw.x11.transfers.entries);
+    free(_glfw.x11.transfers.buffer);
+
+    for (int i = 0;  i < _glfw.x11.clipboardRequests.count;  i++)
+        free(_glfw.x11.clipboardRequests.entries[i].data);
+
+    free(_glfw.x11.clipboardRequests.entries);
+
+    _glfwInvalidateScreenResourcesX11();
+
     if (_glfw.x11.im)
     {
         XCloseIM(_glfw.x11.im);
@@ -1170,6 +1481,18 @@ void _glfwPlatformTerminate(void)
         _glfw.x11.xrender.handle = NULL;
     }
 
+    if (_glfw.x11.xshm.handle)
+    {
+        _glfw_dlclose(_glfw.x11.xshm.handle);
+        _glfw.x11.xshm.handle = NULL;
+    }
+
+    if (_glfw.x11.present.handle)
+    {
+        _glfw_dlclose(_glfw.x11.present.handle);
+        _glfw.x11.present.handle = NULL;
+    }
+
     if (_glfw.x11.vidmode.handle)
     {
         _glfw_dlclose(_glfw.x11.vidmode.handle);
@@ -1187,6 +1510,12 @@ void _glfwPlatformTerminate(void)
     _glfwTerminateEGL();
     _glfwTerminateGLX();
 
+    free(_glfw.x11.pollfds);
+    free(_glfw.x11.windowTable.slots);
+    closePipe(_glfw.x11.emptyEventPipe);
+    closePipe(_glfw.x11.eventThread.wakePipe);
+    closePipe(_glfw.x11.eventThread.stopPipe);
+
 #if defined(__linux__)
     _glfwTerminateJoysticksLinux();
 #endif
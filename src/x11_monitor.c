@@ -92,27 +92,108 @@ static GLFWvidmode vidmodeFromModeInfo(const XRRModeInfo* mi,
 }
 
 
+// Returns the screen resources, which are cached until the next output or
+// screen change
+//
+static XRRScreenResources* getScreenResources(void)
+{
+    if (!_glfw.x11.randr.resources)
+    {
+        _glfw.x11.randr.resources =
+            XRRGetScreenResourcesCurrent(_glfw.x11.display, _glfw.x11.root);
+    }
+
+    return _glfw.x11.randr.resources;
+}
+
+// Returns the monitor for the specified RandR output, if it is connected
+//
+static _GLFWmonitor* findMonitor(RROutput output)
+{
+    for (int i = 0;  i < _glfw.monitorCount;  i++)
+    {
+        if (_glfw.monitors[i]->x11.output == output)
+            return _glfw.monitors[i];
+    }
+
+    return NULL;
+}
+
+// Creates and connects a monitor for the specified RandR output
+//
+static void connectMonitor(XRRScreenResources* sr,
+                           RROutput output,
+                           const XRROutputInfo* oi,
+                           RROutput primary)
+{
+    int type, widthMM, heightMM;
+
+    XRRCrtcInfo* ci = XRRGetCrtcInfo(_glfw.x11.display, sr, oi->crtc);
+    if (ci->rotation == RR_Rotate_90 || ci->rotation == RR_Rotate_270)
+    {
+        widthMM  = oi->mm_height;
+        heightMM = oi->mm_width;
+    }
+    else
+    {
+        widthMM  = oi->mm_width;
+        heightMM = oi->mm_height;
+    }
+
+    if (widthMM <= 0 || heightMM <= 0)
+    {
+        // HACK: If RandR does not provide a physical size, assume the
+        //       X11 default 96 DPI and calculate from the CRTC viewport
+        // NOTE: These members are affected by rotation, unlike the mode
+        //       info and output info members
+        widthMM  = (int) (ci->width * 25.4f / 96.f);
+        heightMM = (int) (ci->height * 25.4f / 96.f);
+    }
+
+    _GLFWmonitor* monitor = _glfwAllocMonitor(oi->name, widthMM, heightMM);
+    monitor->x11.output = output;
+    monitor->x11.crtc   = oi->crtc;
+
+    if (monitor->x11.output == primary)
+        type = _GLFW_INSERT_FIRST;
+    else
+        type = _GLFW_INSERT_LAST;
+
+    _glfwInputMonitor(monitor, GLFW_CONNECTED, type);
+
+    XRRFreeCrtcInfo(ci);
+}
+
 //////////////////////////////////////////////////////////////////////////
 //////                       GLFW internal API                      //////
 //////////////////////////////////////////////////////////////////////////
 
+// Drops the cached screen resources, so they are fetched again when next used
+//
+void _glfwInvalidateScreenResourcesX11(void)
+{
+    if (_glfw.x11.randr.resources)
+    {
+        XRRFreeScreenResources(_glfw.x11.randr.resources);
+        _glfw.x11.randr.resources = NULL;
+    }
+}
+
 // Poll for changes in the set of connected monitors
 //
 void _glfwPollMonitorsX11(void)
 {
     if (_glfw.x11.randr.available && !_glfw.x11.randr.monitorBroken)
     {
-        int disconnectedCount, screenCount = 0;
+        int disconnectedCount;
         _GLFWmonitor** disconnected = NULL;
-        XineramaScreenInfo* screens = NULL;
-        XRRScreenResources* sr = XRRGetScreenResourcesCurrent(_glfw.x11.display,
-                                                              _glfw.x11.root);
+
+        _glfwInvalidateScreenResourcesX11();
+
+        XRRScreenResources* sr = getScreenResources();
         RROutput primary = XRRGetOutputPrimary(_glfw.x11.display,
                                                _glfw.x11.root);
 
-        if (_glfw.x11.xinerama.available)
-            screens = XineramaQueryScreens(_glfw.x11.display, &screenCount);
-
         disconnectedCount = _glfw.monitorCount;
         if (disconnectedCount)
         {
@@ -124,7 +205,7 @@ void _glfwPollMonitorsX11(void)
 
         for (int i = 0;  i < sr->noutput;  i++)
         {
-            int j, type, widthMM, heightMM;
+            int j;
 
             XRROutputInfo* oi = XRRGetOutputInfo(_glfw.x11.display, sr, sr->outputs[i]);
             if (oi->connection != RR_Connected || oi->crtc == None)
@@ -143,66 +224,12 @@ void _glfwPollMonitorsX11(void)
                 }
             }
 
-            if (j < disconnectedCount)
-            {
-                XRRFreeOutputInfo(oi);
-                continue;
-            }
-
-            XRRCrtcInfo* ci = XRRGetCrtcInfo(_glfw.x11.display, sr, oi->crtc);
-            if (ci->rotation == RR_Rotate_90 || ci->rotation == RR_Rotate_270)
-            {
-                widthMM  = oi->mm_height;
-                heightMM = oi->mm_width;
-            }
-            else
-            {
-                widthMM  = oi->mm_width;
-                heightMM = oi->mm_height;
-            }
-
-            if (widthMM <= 0 || heightMM <= 0)
-            {
-                // HACK: If RandR does not provide a physical size, assume the
-                //       X11 default 96 DPI and calculate from the CRTC viewport
-                // NOTE: These members are affected by rotation, unlike the mode
-                //       info and output info members
-                widthMM  = (int) (ci->width * 25.4f / 96.f);
-                heightMM = (int) (ci->height * 25.4f / 96.f);
-            }
-
-            _GLFWmonitor* monitor = _glfwAllocMonitor(oi->name, widthMM, heightMM);
-            monitor->x11.output = sr->outputs[i];
-            monitor->x11.crtc   = oi->crtc;
-
-            for (j = 0;  j < screenCount;  j++)
-            {
-                if (screens[j].x_org == ci->x &&
-                    screens[j].y_org == ci->y &&
-                    screens[j].width == ci->width &&
-                    screens[j].height == ci->height)
-                {
-                    monitor->x11.index = j;
-                    break;
-                }
-            }
-
-            if (monitor->x11.output == primary)
-                type = _GLFW_INSERT_FIRST;
-            else
-                type = _GLFW_INSERT_LAST;
-
-            _glfwInputMonitor(monitor, GLFW_CONNECTED, type);
+            if (j == disconnectedCount)
+                connectMonitor(sr, sr->outputs[i], oi, primary);
 
             XRRFreeOutputInfo(oi);
-            XRRFreeCrtcInfo(ci);
         }
 
-        XRRFreeScreenResources(sr);
-
-        if (screens)
-            XFree(screens);
-
         for (int i = 0;  i < disconnectedCount;  i++)
         {
             if (disconnected[i])
@@ -222,6 +249,45 @@ void _glfwPollMonitorsX11(void)
     }
 }
 
+// Updates the monitor of a single RandR output after it has changed
+//
+void _glfwUpdateOutputX11(const XRROutputChangeNotifyEvent* event)
+{
+    _GLFWmonitor* monitor = findMonitor(event->output);
+
+    // The change may have added outputs or modes to the screen resources
+    _glfwInvalidateScreenResourcesX11();
+
+    if (event->connection != RR_Connected || event->crtc == None)
+    {
+        if (monitor)
+            _glfwInputMonitor(monitor, GLFW_DISCONNECTED, 0);
+
+        return;
+    }
+
+    if (monitor)
+    {
+        // Only the CRTC is retained, everything else is queried when needed
+        monitor->x11.crtc = event->crtc;
+        return;
+    }
+
+    XRRScreenResources* sr = getScreenResources();
+    XRROutputInfo* oi = XRRGetOutputInfo(_glfw.x11.display, sr, event->output);
+
+    // The event may be stale if the output has changed again since
+    if (oi->connection == RR_Connected && oi->crtc != None)
+    {
+        RROutput primary = XRRGetOutputPrimary(_glfw.x11.display,
+                                               _glfw.x11.root);
+
+        connectMonitor(sr, event->output, oi, primary);
+    }
+
+    XRRFreeOutputInfo(oi);
+}
+
 // Set the current video mode for the specified monitor
 //
 void _glfwSetVideoModeX11(_GLFWmonitor* monitor, const GLFWvidmode* desired)
@@ -236,8 +302,12 @@ void _glfwSetVideoModeX11(_GLFWmonitor* monitor, const GLFWvidmode* desired)
         if (_glfwCompareVideoModes(&current, best) == 0)
             return;
 
-        XRRScreenResources* sr =
-            XRRGetScreenResourcesCurrent(_glfw.x11.display, _glfw.x11.root);
+        // NOTE: The configuration time of the resources is sent with the new
+        //       configuration and must be current for it to be accepted, even
+        //       if a change has not yet been processed
+        _glfwInvalidateScreenResourcesX11();
+
+        XRRScreenResources* sr = getScreenResources();
         XRRCrtcInfo* ci = XRRGetCrtcInfo(_glfw.x11.display, sr, monitor->x11.crtc);
         XRROutputInfo* oi = XRRGetOutputInfo(_glfw.x11.display, sr, monitor->x11.output);
 
@@ -272,7 +342,6 @@ void _glfwSetVideoModeX11(_GLFWmonitor* monitor, const GLFWvidmode* desired)
 
         XRRFreeOutputInfo(oi);
         XRRFreeCrtcInfo(ci);
-        XRRFreeScreenResources(sr);
     }
 }
 
@@ -285,8 +354,10 @@ void _glfwRestoreVideoModeX11(_GLFWmonitor* monitor)
         if (monitor->x11.oldMode == None)
             return;
 
-        XRRScreenResources* sr =
-            XRRGetScreenResourcesCurrent(_glfw.x11.display, _glfw.x11.root);
+        // The configuration time sent with the old mode must be current
+        _glfwInvalidateScreenResourcesX11();
+
+        XRRScreenResources* sr = getScreenResources();
         XRRCrtcInfo* ci = XRRGetCrtcInfo(_glfw.x11.display, sr, monitor->x11.crtc);
 
         XRRSetCrtcConfig(_glfw.x11.display,
@@ -299,12 +370,51 @@ void _glfwRestoreVideoModeX11(_GLFWmonitor* monitor)
                          ci->noutput);
 
         XRRFreeCrtcInfo(ci);
-        XRRFreeScreenResources(sr);
 
         monitor->x11.oldMode = None;
     }
 }
 
+// Returns the index of the Xinerama screen matching the specified monitor,
+// for EWMH full screen window placement
+//
+int _glfwGetXineramaIndexX11(_GLFWmonitor* monitor)
+{
+    int index = 0;
+
+    if (!_glfwLoadXineramaX11())
+        return index;
+
+    if (_glfw.x11.randr.available && !_glfw.x11.randr.monitorBroken)
+    {
+        int screenCount = 0;
+        XineramaScreenInfo* screens =
+            XineramaQueryScreens(_glfw.x11.display, &screenCount);
+
+        XRRScreenResources* sr = getScreenResources();
+        XRRCrtcInfo* ci = XRRGetCrtcInfo(_glfw.x11.display, sr, monitor->x11.crtc);
+
+        for (int i = 0;  i < screenCount;  i++)
+        {
+            if (screens[i].x_org == ci->x &&
+                screens[i].y_org == ci->y &&
+                screens[i].width == ci->width &&
+                screens[i].height == ci->height)
+            {
+                index = i;
+                break;
+            }
+        }
+
+        XRRFreeCrtcInfo(ci);
+
+        if (screens)
+            XFree(screens);
+    }
+
+    return index;
+}
+
 
 //////////////////////////////////////////////////////////////////////////
 //////                       GLFW platform API                      //////
@@ -318,8 +428,7 @@ void _glfwPlatformGetMonitorPos(_GLFWmonitor* monitor, int* xpos, int* ypos)
 {
     if (_glfw.x11.randr.available && !_glfw.x11.randr.monitorBroken)
     {
-        XRRScreenResources* sr =
-            XRRGetScreenResourcesCurrent(_glfw.x11.display, _glfw.x11.root);
+        XRRScreenResources* sr = getScreenResources();
         XRRCrtcInfo* ci = XRRGetCrtcInfo(_glfw.x11.display, sr, monitor->x11.crtc);
 
         if (ci)
@@ -331,8 +440,6 @@ void _glfwPlatformGetMonitorPos(_GLFWmonitor* monitor, int* xpos, int* ypos)
 
             XRRFreeCrtcInfo(ci);
         }
-
-        XRRFreeScreenResources(sr);
     }
 }
 
@@ -351,8 +458,7 @@ void _glfwPlatformGetMonitorWorkarea(_GLFWmonitor* monitor, int* xpos, int* ypos
 
     if (_glfw.x11.randr.available && !_glfw.x11.randr.monitorBroken)
     {
-        XRRScreenResources* sr =
-            XRRGetScreenResourcesCurrent(_glfw.x11.display, _glfw.x11.root);
+        XRRScreenResources* sr = getScreenResources();
         XRRCrtcInfo* ci = XRRGetCrtcInfo(_glfw.x11.display, sr, monitor->x11.crtc);
 
         areaX = ci->x;
@@ -372,7 +478,6 @@ void _glfwPlatformGetMonitorWorkarea(_GLFWmonitor* monitor, int* xpos, int* ypos
         }
 
         XRRFreeCrtcInfo(ci);
-        XRRFreeScreenResources(sr);
     }
     else
     {
@@ -445,8 +550,7 @@ GLFWvidmode* _glfwPlatformGetVideoModes(_GLFWmonitor* monitor, int* count)
 
     if (_glfw.x11.randr.available && !_glfw.x11.randr.monitorBroken)
     {
-        XRRScreenResources* sr =
-            XRRGetScreenResourcesCurrent(_glfw.x11.display, _glfw.x11.root);
+        XRRScreenResources* sr = getScreenResources();
         XRRCrtcInfo* ci = XRRGetCrtcInfo(_glfw.x11.display, sr, monitor->x11.crtc);
         XRROutputInfo* oi = XRRGetOutputInfo(_glfw.x11.display, sr, monitor->x11.output);
 
@@ -477,7 +581,6 @@ GLFWvidmode* _glfwPlatformGetVideoModes(_GLFWmonitor* monitor, int* count)
 
         XRRFreeOutputInfo(oi);
         XRRFreeCrtcInfo(ci);
-        XRRFreeScreenResources(sr);
     }
     else
     {
@@ -493,8 +596,7 @@ void _glfwPlatformGetVideoMode(_GLFWmonitor* monitor, GLFWvidmode* mode)
 {
     if (_glfw.x11.randr.available && !_glfw.x11.randr.monitorBroken)
     {
-        XRRScreenResources* sr =
-            XRRGetScreenResourcesCurrent(_glfw.x11.display, _glfw.x11.root);
+        XRRScreenResources* sr = getScreenResources();
         XRRCrtcInfo* ci = XRRGetCrtcInfo(_glfw.x11.display, sr, monitor->x11.crtc);
 
         if (ci)
@@ -505,8 +607,6 @@ void _glfwPlatformGetVideoMode(_GLFWmonitor* monitor, GLFWvidmode* mode)
 
             XRRFreeCrtcInfo(ci);
         }
-
-        XRRFreeScreenResources(sr);
     }
     else
     {
@@ -537,7 +637,7 @@ GLFWbool _glfwPlatformGetGammaRamp(_GLFWmonitor* monitor, GLFWgammaramp* ramp)
         XRRFreeGamma(gamma);
         return GLFW_TRUE;
     }
-    else if (_glfw.x11.vidmode.available)
+    else if (_glfwLoadVidmodeX11())
     {
         int size;
         XF86VidModeGetGammaRampSize(_glfw.x11.display, _glfw.x11.screen, &size);
@@ -577,7 +677,7 @@ void _glfwPlatformSetGammaRamp(_GLFWmonitor* monitor, const GLFWgammaramp* ramp)
         XRRSetCrtcGamma(_glfw.x11.display, monitor->x11.crtc, gamma);
         XRRFreeGamma(gamma);
     }
-    else if (_glfw.x11.vidmode.available)
+    else if (_glfwLoadVidmodeX11())
     {
         XF86VidModeSetGammaRamp(_glfw.x11.display,
                                 _glfw.x11.screen,
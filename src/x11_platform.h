@@ -29,6 +29,8 @@
 #include <signal.h>
 #include <stdint.h>
 #include <dlfcn.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
 
 #include <X11/Xlib.h>
 #include <X11/keysym.h>
@@ -47,6 +49,12 @@
 // The XInput extension provides raw mouse motion input
 #include <X11/extensions/XInput2.h>
 
+// The MIT-SHM extension provides shared memory pixel transfers
+#include <X11/extensions/XShm.h>
+
+// The Present extension provides frame completion events
+#include <X11/extensions/presenttokens.h>
+
 typedef XRRCrtcGamma* (* PFN_XRRAllocGamma)(int);
 typedef void (* PFN_XRRFreeCrtcInfo)(XRRCrtcInfo*);
 typedef void (* PFN_XRRFreeGamma)(XRRCrtcGamma*);
@@ -123,6 +131,42 @@ typedef XRenderPictFormat* (* PFN_XRenderFindVisualFormat)(Display*,Visual const
 #define XRenderQueryVersion _glfw.x11.xrender.QueryVersion
 #define XRenderFindVisualFormat _glfw.x11.xrender.FindVisualFormat
 
+typedef Bool (* PFN_XShmQueryExtension)(Display*);
+typedef int (* PFN_XShmGetEventBase)(Display*);
+typedef Bool (* PFN_XShmAttach)(Display*,XShmSegmentInfo*);
+typedef Bool (* PFN_XShmDetach)(Display*,XShmSegmentInfo*);
+typedef XImage* (* PFN_XShmCreateImage)(Display*,Visual*,unsigned int,int,char*,XShmSegmentInfo*,unsigned int,unsigned int);
+typedef Bool (* PFN_XShmPutImage)(Display*,Drawable,GC,XImage*,int,int,int,int,unsigned int,unsigned int,Bool);
+#define XShmQueryExtension _glfw.x11.xshm.QueryExtension
+#define XShmGetEventBase _glfw.x11.xshm.GetEventBase
+#define XShmAttach _glfw.x11.xshm.Attach
+#define XShmDetach _glfw.x11.xshm.Detach
+#define XShmCreateImage _glfw.x11.xshm.CreateImage
+#define XShmPutImage _glfw.x11.xshm.PutImage
+
+typedef struct XPresentCompleteNotifyEvent
+{
+    int type;
+    unsigned long serial;
+    Bool send_event;
+    Display* display;
+    int extension;
+    int evtype;
+    uint32_t eid;
+    Window window;
+    uint32_t serial_number;
+    uint64_t ust;
+    uint64_t msc;
+    uint8_t kind;
+    uint8_t mode;
+} XPresentCompleteNotifyEvent;
+typedef Bool (* PFN_XPresentQueryExtension)(Display*,int*,int*,int*);
+typedef Status (* PFN_XPresentQueryVersion)(Display*,int*,int*);
+typedef XID (* PFN_XPresentSelectInput)(Display*,Window,unsigned int);
+#define XPresentQueryExtension _glfw.x11.present.QueryExtension
+#define XPresentQueryVersion _glfw.x11.present.QueryVersion
+#define XPresentSelectInput _glfw.x11.present.SelectInput
+
 typedef VkFlags VkXlibSurfaceCreateFlagsKHR;
 typedef VkFlags VkXcbSurfaceCreateFlagsKHR;
 
@@ -151,6 +195,7 @@ typedef VkBool32 (APIENTRY *PFN_vkGetPhysicalDeviceXcbPresentationSupportKHR)(Vk
 
 #include "posix_thread.h"
 #include "posix_time.h"
+#include "posix_poll.h"
 #include "xkb_unicode.h"
 #include "glx_context.h"
 #include "egl_context.h"
@@ -173,6 +218,78 @@ typedef VkBool32 (APIENTRY *PFN_vkGetPhysicalDeviceXcbPresentationSupportKHR)(Vk
 #define _GLFW_PLATFORM_MONITOR_STATE        _GLFWmonitorX11 x11
 #define _GLFW_PLATFORM_CURSOR_STATE         _GLFWcursorX11  x11
 
+// Indices of the descriptors waited on for events, which are followed by those
+// added with glfwAddWaitFd
+#define _GLFW_X11_POLL_DISPLAY      0
+#define _GLFW_X11_POLL_INOTIFY      1
+#define _GLFW_X11_POLL_WAKE         2
+#define _GLFW_X11_POLL_EMPTY_EVENT  3
+#define _GLFW_X11_POLL_COUNT        4
+
+// Maximum number of events moved from the Xlib queue per display lock
+#define _GLFW_X11_EVENT_BATCH_SIZE  64
+
+// Maximum number of 32-bit units read from a selection property at a time
+#define _GLFW_X11_PROPERTY_CHUNK    262144
+
+// Number of converted window icons and created cursors kept for reuse
+#define _GLFW_X11_IMAGE_CACHE_SIZE  8
+
+// X11-specific outgoing INCR selection transfer
+//
+typedef struct _GLFWtransferX11
+{
+    Window          requestor;
+    Atom            property;
+    Atom            target;
+    Atom            selection;
+    size_t          size;
+    size_t          offset;
+} _GLFWtransferX11;
+
+// X11-specific copy of image contents used as a cache key
+//
+typedef struct _GLFWimagekeyX11
+{
+    uint64_t        hash;
+    unsigned char*  data;
+    size_t          size;
+} _GLFWimagekeyX11;
+
+// X11-specific cached _NET_WM_ICON property data
+//
+typedef struct _GLFWiconcacheX11
+{
+    _GLFWimagekeyX11 key;
+    unsigned long   id;
+    unsigned long   lastUse;
+    unsigned long*  data;
+    int             longCount;
+} _GLFWiconcacheX11;
+
+// X11-specific cached custom cursor
+//
+typedef struct _GLFWcursorcacheX11
+{
+    _GLFWimagekeyX11 key;
+    int             xhot, yhot;
+    unsigned long   lastUse;
+    Cursor          handle;
+    int             refs;
+} _GLFWcursorcacheX11;
+
+// X11-specific asynchronous clipboard request
+//
+typedef struct _GLFWclipboardrequestX11
+{
+    Window          requestor;
+    Atom            target;
+    GLFWbool        incremental;
+    char*           data;
+    size_t          size;
+    GLFWclipboardstringfun callback;
+    void*           user;
+} _GLFWclipboardrequestX11;
 
 // X11-specific per-window data
 //
@@ -184,17 +301,22 @@ typedef struct _GLFWwindowX11
     XIC             ic;
 
     GLFWbool        overrideRedirect;
+    // Window states tracked from events, returned by the attribute queries
     GLFWbool        iconified;
     GLFWbool        maximized;
+    GLFWbool        focused;
+    GLFWbool        hovered;
 
     // Whether the visual supports framebuffer transparency
     GLFWbool        transparent;
 
-    // Cached position and size used to filter out duplicate events
+    // Position and size from the last ConfigureNotify, returned by the getters
+    // and used to filter out duplicate events
     int             width, height;
     int             xpos, ypos;
 
-    // The last received cursor position, regardless of source
+    // The last received cursor position, regardless of source, returned by
+    // glfwGetCursorPos
     int             lastCursorPosX, lastCursorPosY;
     // The last position the cursor was warped to by GLFW
     int             warpCursorPosX, warpCursorPosY;
@@ -202,8 +324,38 @@ typedef struct _GLFWwindowX11
     // The time of the last KeyPress event per keycode, for discarding
     // duplicate key events generated for some keys by ibus
     Time            keyPressTimes[256];
+
+    // The vertical blank counter when the last frame was shown, for detecting
+    // missed vertical blanks
+    uint64_t        lastMsc;
+
+    // The icon cache entry last written to _NET_WM_ICON, or zero
+    unsigned long   iconId;
+
+    // Pixel buffers for windows without a client API, with two shared memory
+    // images so one can be drawn while the server reads the other
+    struct {
+        XImage*         images[2];
+        XShmSegmentInfo shminfo[2];
+        // Whether the server may still be reading the image
+        GLFWbool        busy[2];
+        int             count;
+        int             back;
+        GC              gc;
+        // Area presented from the front image not yet copied to the back one
+        int             damageX, damageY, damageWidth, damageHeight;
+    } pixels;
 } _GLFWwindowX11;
 
+// X11-specific input event read by the event thread
+//
+typedef struct _GLFWinputeventX11
+{
+    XEvent          event;
+    // Timer value when the event was read from the connection
+    uint64_t        time;
+} _GLFWinputeventX11;
+
 // X11-specific global data
 //
 typedef struct _GLFWlibraryX11
@@ -216,10 +368,22 @@ typedef struct _GLFWlibraryX11
     float           contentScaleX, contentScaleY;
     // Helper window for IPC
     Window          helperWindowHandle;
+    // Pipe written to by glfwPostEmptyEvent to wake up the event loop
+    int             emptyEventPipe[2];
+    // Descriptors waited on for events, indexed by _GLFW_X11_POLL_*
+    struct pollfd*  pollfds;
+    int             pollfdCount;
     // Invisible cursor for hidden cursor mode
     Cursor          hiddenCursorHandle;
-    // Context for mapping window XIDs to _GLFWwindow pointers
-    XContext        context;
+    // Open addressing table mapping window XIDs to _GLFWwindow pointers, with
+    // the most recently found window cached as consecutive events usually
+    // target the same window
+    struct {
+        _GLFWwindow**   slots;
+        int             size;
+        int             count;
+        _GLFWwindow*    last;
+    } windowTable;
     // XIM input method
     XIM             im;
     // Most recent error code received by X error handler
@@ -228,6 +392,35 @@ typedef struct _GLFWlibraryX11
     char*           primarySelectionString;
     // Clipboard string (while the selection is owned)
     char*           clipboardString;
+    // Application clipboard data source (while the selection is owned)
+    struct {
+        Atom            target;
+        size_t          size;
+        GLFWclipboardsourcefun callback;
+        void*           user;
+    } clipboardSource;
+    // Outgoing INCR selection transfers in progress
+    struct {
+        _GLFWtransferX11* entries;
+        int             count;
+        unsigned char*  buffer;
+        size_t          bufferSize;
+    } transfers;
+    // Recently converted window icons, least recently used evicted first
+    struct {
+        _GLFWiconcacheX11 entries[_GLFW_X11_IMAGE_CACHE_SIZE];
+        unsigned long   serial;
+    } iconCache;
+    // Recently created custom cursors, kept while unused until evicted
+    struct {
+        _GLFWcursorcacheX11 entries[_GLFW_X11_IMAGE_CACHE_SIZE];
+        unsigned long   serial;
+    } cursorCache;
+    // Asynchronous clipboard requests awaiting a reply
+    struct {
+        _GLFWclipboardrequestX11* entries;
+        int             count;
+    } clipboardRequests;
     // Key name string
     char            keynames[GLFW_KEY_LAST + 1][5];
     // X11 keycode to GLFW key LUT
@@ -291,6 +484,8 @@ typedef struct _GLFWlibraryX11
     Atom            SAVE_TARGETS;
     Atom            NULL_;
     Atom            UTF8_STRING;
+    Atom            text_plain;
+    Atom            text_plain_utf8;
     Atom            COMPOUND_STRING;
     Atom            ATOM_PAIR;
     Atom            GLFW_SELECTION;
@@ -304,6 +499,8 @@ typedef struct _GLFWlibraryX11
         int         minor;
         GLFWbool    gammaBroken;
         GLFWbool    monitorBroken;
+        // Screen resources cached until the next output change
+        XRRScreenResources* resources;
         PFN_XRRAllocGamma AllocGamma;
         PFN_XRRFreeCrtcInfo FreeCrtcInfo;
         PFN_XRRFreeGamma FreeGamma;
@@ -349,6 +546,7 @@ typedef struct _GLFWlibraryX11
     } xdnd;
 
     struct {
+        GLFWbool    loaded;
         void*       handle;
         PFN_XcursorImageCreate ImageCreate;
         PFN_XcursorImageDestroy ImageDestroy;
@@ -356,6 +554,7 @@ typedef struct _GLFWlibraryX11
     } xcursor;
 
     struct {
+        GLFWbool    loaded;
         GLFWbool    available;
         void*       handle;
         int         major;
@@ -371,6 +570,7 @@ typedef struct _GLFWlibraryX11
     } x11xcb;
 
     struct {
+        GLFWbool    loaded;
         GLFWbool    available;
         void*       handle;
         int         eventBase;
@@ -382,6 +582,7 @@ typedef struct _GLFWlibraryX11
     } vidmode;
 
     struct {
+        GLFWbool    loaded;
         GLFWbool    available;
         void*       handle;
         int         majorOpcode;
@@ -394,6 +595,7 @@ typedef struct _GLFWlibraryX11
     } xi;
 
     struct {
+        GLFWbool    loaded;
         GLFWbool    available;
         void*       handle;
         int         major;
@@ -404,6 +606,63 @@ typedef struct _GLFWlibraryX11
         PFN_XRenderQueryVersion QueryVersion;
         PFN_XRenderFindVisualFormat FindVisualFormat;
     } xrender;
+
+    struct {
+        GLFWbool    loaded;
+        GLFWbool    available;
+        void*       handle;
+        int         eventBase;
+        PFN_XShmQueryExtension QueryExtension;
+        PFN_XShmGetEventBase GetEventBase;
+        PFN_XShmAttach Attach;
+        PFN_XShmDetach Detach;
+        PFN_XShmCreateImage CreateImage;
+        PFN_XShmPutImage PutImage;
+    } xshm;
+
+    struct {
+        GLFWbool    loaded;
+        GLFWbool    available;
+        void*       handle;
+        int         majorOpcode;
+        int         eventBase;
+        int         errorBase;
+        int         major;
+        int         minor;
+        PFN_XPresentQueryExtension QueryExtension;
+        PFN_XPresentQueryVersion QueryVersion;
+        PFN_XPresentSelectInput SelectInput;
+    } present;
+
+    struct {
+        GLFWbool        running;
+        pthread_t       thread;
+        // Pipe written to by the event thread when it has read from the
+        // connection
+        int             wakePipe[2];
+        // Pipe written to by the main thread to stop the event thread
+        int             stopPipe[2];
+        // Input events read by the event thread, guarded by lock
+        pthread_mutex_t lock;
+        _GLFWinputeventX11* pending;
+        int             pendingCount;
+        int             pendingSize;
+        // Input events taken by the main thread for processing
+        _GLFWinputeventX11* events;
+        int             count;
+        int             size;
+        int             next;
+        // Read time of the event being processed, or zero for Xlib events
+        uint64_t        time;
+    } eventThread;
+
+    // Events moved from the Xlib queue to be processed without holding the
+    // display lock
+    struct {
+        XEvent          events[_GLFW_X11_EVENT_BATCH_SIZE];
+        int             count;
+        int             next;
+    } eventBatch;
 } _GLFWlibraryX11;
 
 // X11-specific per-monitor data
@@ -413,10 +672,6 @@ typedef struct _GLFWmonitorX11
     RROutput        output;
     RRCrtc          crtc;
     RRMode          oldMode;
-
-    // Index of corresponding Xinerama screen,
-    // for EWMH full screen window placement
-    int             index;
 } _GLFWmonitorX11;
 
 // X11-specific per-cursor data
@@ -428,8 +683,19 @@ typedef struct _GLFWcursorX11
 
 
 void _glfwPollMonitorsX11(void);
+void _glfwUpdateOutputX11(const XRROutputChangeNotifyEvent* event);
+void _glfwInvalidateScreenResourcesX11(void);
 void _glfwSetVideoModeX11(_GLFWmonitor* monitor, const GLFWvidmode* desired);
 void _glfwRestoreVideoModeX11(_GLFWmonitor* monitor);
+int _glfwGetXineramaIndexX11(_GLFWmonitor* monitor);
+
+GLFWbool _glfwLoadVidmodeX11(void);
+GLFWbool _glfwLoadXiX11(void);
+GLFWbool _glfwLoadXcursorX11(void);
+GLFWbool _glfwLoadXineramaX11(void);
+GLFWbool _glfwLoadXrenderX11(void);
+GLFWbool _glfwLoadXshmX11(void);
+GLFWbool _glfwLoadPresentX11(void);
 
 Cursor _glfwCreateCursorX11(const GLFWimage* image, int xhot, int yhot);
 
@@ -445,3 +711,6 @@ void _glfwInputErrorX11(int error, const char* message);
 
 void _glfwPushSelectionToManagerX11(void);
 
+GLFWbool _glfwStartEventThreadX11(void);
+void _glfwStopEventThreadX11(void);
+
@@ -32,7 +32,7 @@
 #include <X11/cursorfont.h>
 #include <X11/Xmd.h>
 
-#include <sys/select.h>
+#include <unistd.h>
 
 #include <string.h>
 #include <stdio.h>
@@ -57,514 +57,1128 @@
 #define _GLFW_XDND_VERSION 5
 
 
-// Wait for data to arrive using select
-// This avoids blocking other threads via the per-display Xlib lock that also
-// covers GLX functions
+// Writes a byte to the specified pipe to wake up the thread waiting on it
 //
-static GLFWbool waitForEvent(double* timeout)
+static void writeToPipe(int fd)
 {
-    fd_set fds;
-    const int fd = ConnectionNumber(_glfw.x11.display);
-    int count = fd + 1;
-
-#if defined(__linux__)
-    if (_glfw.linjs.inotify > fd)
-        count = _glfw.linjs.inotify + 1;
-#endif
     for (;;)
     {
-        FD_ZERO(&fds);
-        FD_SET(fd, &fds);
-#if defined(__linux__)
-        if (_glfw.linjs.inotify > 0)
-            FD_SET(_glfw.linjs.inotify, &fds);
-#endif
+        const char byte = 0;
+        const ssize_t result = write(fd, &byte, 1);
+        if (result == 1 || (result == -1 && errno != EINTR))
+            break;
+    }
+}
 
-        if (timeout)
-        {
-            const long seconds = (long) *timeout;
-            const long microseconds = (long) ((*timeout - seconds) * 1e6);
-            struct timeval tv = { seconds, microseconds };
-            const uint64_t base = _glfwPlatformGetTimerValue();
+// Reads all pending bytes from the specified pipe
+//
+static void drainPipe(int fd)
+{
+    for (;;)
+    {
+        char dummy[64];
+        const ssize_t result = read(fd, dummy, sizeof(dummy));
+        if (result == -1 && errno == EINTR)
+            continue;
+        if (result != (ssize_t) sizeof(dummy))
+            break;
+    }
+}
 
-            const int result = select(count, &fds, NULL, NULL, &tv);
-            const int error = errno;
+// Wait for data to arrive on any of the specified file descriptors using poll
+// This avoids blocking other threads via the per-display Xlib lock that also
+// covers GLX functions
+//
+static GLFWbool waitForData(struct pollfd* fds, nfds_t count, double* timeout)
+{
+    if (timeout)
+    {
+        const uint64_t deadline = _glfwGetDeadlinePOSIX(*timeout);
+        const GLFWbool result = _glfwPollPOSIX(fds, count, &deadline);
+        const uint64_t now = _glfwPlatformGetTimerValue();
 
-            *timeout -= (_glfwPlatformGetTimerValue() - base) /
+        if (deadline > now)
+        {
+            *timeout = (deadline - now) /
                 (double) _glfwPlatformGetTimerFrequency();
-
-            if (result > 0)
-                return GLFW_TRUE;
-            if ((result == -1 && error == EINTR) || *timeout <= 0.0)
-                return GLFW_FALSE;
         }
-        else if (select(count, &fds, NULL, NULL, NULL) != -1 || errno != EINTR)
-            return GLFW_TRUE;
+        else
+            *timeout = 0.0;
+
+        return result;
     }
+
+    return _glfwPollPOSIX(fds, count, NULL);
 }
 
-// Waits until a VisibilityNotify event arrives for the specified window or the
-// timeout period elapses (ICCCM section 4.2.2)
+// Wait for data to arrive on the X connection
 //
-static GLFWbool waitForVisibilityNotify(_GLFWwindow* window)
+static GLFWbool waitForEvent(double* timeout)
 {
-    XEvent dummy;
-    double timeout = 0.1;
+    const GLFWbool result = waitForData(_glfw.x11.pollfds,
+                                        _GLFW_X11_POLL_EMPTY_EVENT,
+                                        timeout);
 
-    while (!XCheckTypedWindowEvent(_glfw.x11.display,
-                                   window->x11.handle,
-                                   VisibilityNotify,
-                                   &dummy))
-    {
-        if (!waitForEvent(&timeout))
-            return GLFW_FALSE;
-    }
+    // NOTE: The event thread may have read the awaited event into the Xlib
+    //       queue, in which case the connection will not become readable
+    if (_glfw.x11.eventThread.running)
+        drainPipe(_glfw.x11.eventThread.wakePipe[0]);
 
-    return GLFW_TRUE;
+    return result;
 }
 
-// Returns whether the window is iconified
+// Wait for data to arrive on the X connection, for an empty event or on any of
+// the file descriptors added with glfwAddWaitFd, until the specified timer
+// deadline or indefinitely if it is NULL
+// Returns whether waiting should end regardless of the X connection, i.e. the
+// deadline has passed or a descriptor other than the X connection is ready
 //
-static int getWindowState(_GLFWwindow* window)
+static GLFWbool waitForAnyEvent(const uint64_t* deadline)
 {
-    int result = WithdrawnState;
-    struct {
-        CARD32 state;
-        Window icon;
-    } *state = NULL;
+    int i;
 
-    if (_glfwGetWindowPropertyX11(window->x11.handle,
-                                  _glfw.x11.WM_STATE,
-                                  _glfw.x11.WM_STATE,
-                                  (unsigned char**) &state) >= 2)
+    if (!_glfwPollPOSIX(_glfw.x11.pollfds, _glfw.x11.pollfdCount, deadline))
+        return GLFW_TRUE;
+
+    for (i = 0;  i < _glfw.x11.pollfdCount;  i++)
     {
-        result = state->state;
+        if (i != _GLFW_X11_POLL_DISPLAY && _glfw.x11.pollfds[i].revents)
+            return GLFW_TRUE;
     }
 
-    if (state)
-        XFree(state);
-
-    return result;
+    return GLFW_FALSE;
 }
 
-// Returns whether the event is a selection event
+// Calls the callbacks of the file descriptors added with glfwAddWaitFd that are
+// ready
 //
-static Bool isSelectionEvent(Display* display, XEvent* event, XPointer pointer)
+static void dispatchWaitFds(void)
 {
-    if (event->xany.window != _glfw.x11.helperWindowHandle)
-        return False;
+    int i;
+    const int count = _glfw.x11.pollfdCount - _GLFW_X11_POLL_COUNT;
 
-    return event->type == SelectionRequest ||
-           event->type == SelectionNotify ||
-           event->type == SelectionClear;
+    if (count <= 0)
+        return;
+
+    if (poll(_glfw.x11.pollfds + _GLFW_X11_POLL_COUNT, count, 0) <= 0)
+        return;
+
+    // NOTE: A callback may add or remove descriptors, so the array is re-read
+    //       on each iteration and a ready descriptor shifted to an index that
+    //       was already visited is handled by the next call instead
+    for (i = _GLFW_X11_POLL_COUNT;  i < _glfw.x11.pollfdCount;  i++)
+    {
+        if (_glfw.x11.pollfds[i].revents)
+        {
+            const int fd = _glfw.x11.pollfds[i].fd;
+            _glfw.x11.pollfds[i].revents = 0;
+            _glfwInputWaitFd(fd);
+        }
+    }
 }
 
-// Returns whether it is a _NET_FRAME_EXTENTS event for the specified window
+// Returns whether the event is read by the event thread
 //
-static Bool isFrameExtentsEvent(Display* display, XEvent* event, XPointer pointer)
+static GLFWbool isInputEvent(const XEvent* event)
 {
-    _GLFWwindow* window = (_GLFWwindow*) pointer;
-    return event->type == PropertyNotify &&
-           event->xproperty.state == PropertyNewValue &&
-           event->xproperty.window == window->x11.handle &&
-           event->xproperty.atom == _glfw.x11.NET_FRAME_EXTENTS;
+    switch (event->type)
+    {
+        case KeyPress:
+        case KeyRelease:
+        case ButtonPress:
+        case ButtonRelease:
+        case MotionNotify:
+        case EnterNotify:
+        case LeaveNotify:
+            return GLFW_TRUE;
+    }
+
+    return GLFW_FALSE;
 }
 
-// Returns whether it is a property event for the specified selection transfer
+// Moves the input events at the head of the Xlib queue to the pending event
+// array, stopping at the first event of any other kind
+// This is called by the event thread with the display locked
 //
-static Bool isSelPropNewValueNotify(Display* display, XEvent* event, XPointer pointer)
+// NOTE: Events are only moved from the head of the queue, so every event read
+//       by this thread was received before every event left in the Xlib queue
+//       and the main thread can process both in order by emptying the array
+//       first
+//
+static void readInputEvents(void)
 {
-    XEvent* notification = (XEvent*) pointer;
-    return event->type == PropertyNotify &&
-           event->xproperty.state == PropertyNewValue &&
-           event->xproperty.window == notification->xselection.requestor &&
-           event->xproperty.atom == notification->xselection.property;
+    XEvent event;
+    const uint64_t time = _glfwPlatformGetTimerValue();
+
+    pthread_mutex_lock(&_glfw.x11.eventThread.lock);
+
+    while (XQLength(_glfw.x11.display))
+    {
+        XPeekEvent(_glfw.x11.display, &event);
+        if (!isInputEvent(&event))
+            break;
+
+        if (_glfw.x11.eventThread.pendingCount == _glfw.x11.eventThread.pendingSize)
+        {
+            const int size = _glfw.x11.eventThread.pendingSize ?
+                _glfw.x11.eventThread.pendingSize * 2 : 64;
+            _GLFWinputeventX11* pending =
+                realloc(_glfw.x11.eventThread.pending,
+                        size * sizeof(_GLFWinputeventX11));
+
+            // NOTE: Leave the remaining events for the main thread to process
+            //       from the Xlib queue rather than dropping them
+            if (!pending)
+                break;
+
+            _glfw.x11.eventThread.pending = pending;
+            _glfw.x11.eventThread.pendingSize = size;
+        }
+
+        _GLFWinputeventX11* input =
+            _glfw.x11.eventThread.pending + _glfw.x11.eventThread.pendingCount;
+        XNextEvent(_glfw.x11.display, &input->event);
+        input->time = time;
+        _glfw.x11.eventThread.pendingCount++;
+    }
+
+    pthread_mutex_unlock(&_glfw.x11.eventThread.lock);
 }
 
-// Translates an X event modifier state mask
+// Entry point of the event thread
 //
-static int translateState(int state)
+static void* eventThreadMain(void* argument)
 {
-    int mods = 0;
+    struct pollfd fds[] =
+    {
+        { ConnectionNumber(_glfw.x11.display), POLLIN },
+        { _glfw.x11.eventThread.stopPipe[0], POLLIN }
+    };
 
-    if (state & ShiftMask)
-        mods |= GLFW_MOD_SHIFT;
-    if (state & ControlMask)
-        mods |= GLFW_MOD_CONTROL;
-    if (state & Mod1Mask)
-        mods |= GLFW_MOD_ALT;
-    if (state & Mod4Mask)
-        mods |= GLFW_MOD_SUPER;
-    if (state & LockMask)
-        mods |= GLFW_MOD_CAPS_LOCK;
-    if (state & Mod2Mask)
-        mods |= GLFW_MOD_NUM_LOCK;
+    for (;;)
+    {
+        int queued;
 
-    return mods;
+        if (poll(fds, 2, -1) == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            break;
+        }
+
+        if (fds[1].revents)
+            break;
+
+        XLockDisplay(_glfw.x11.display);
+
+        queued = XEventsQueued(_glfw.x11.display, QueuedAfterReading);
+        if (queued)
+            readInputEvents();
+
+        XUnlockDisplay(_glfw.x11.display);
+
+        // NOTE: Wake the main thread even if only non-input events were read,
+        //       as the connection will no longer be readable for it
+        if (queued)
+            writeToPipe(_glfw.x11.eventThread.wakePipe[1]);
+    }
+
+    return NULL;
 }
 
-// Translates an X11 key code to a GLFW key token
+// Takes all input events read so far by the event thread for processing
+// This must be called with the display locked, after all events previously
+// taken have been processed
 //
-static int translateKey(int scancode)
+static void takeInputEvents(void)
 {
-    // Use the pre-filled LUT (see createKeyTables() in x11_init.c)
-    if (scancode < 0 || scancode > 255)
-        return GLFW_KEY_UNKNOWN;
+    _GLFWinputeventX11* events;
+    int size;
 
-    return _glfw.x11.keycodes[scancode];
+    pthread_mutex_lock(&_glfw.x11.eventThread.lock);
+
+    events = _glfw.x11.eventThread.events;
+    size = _glfw.x11.eventThread.size;
+
+    _glfw.x11.eventThread.events = _glfw.x11.eventThread.pending;
+    _glfw.x11.eventThread.count = _glfw.x11.eventThread.pendingCount;
+    _glfw.x11.eventThread.size = _glfw.x11.eventThread.pendingSize;
+
+    _glfw.x11.eventThread.pending = events;
+    _glfw.x11.eventThread.pendingCount = 0;
+    _glfw.x11.eventThread.pendingSize = size;
+
+    pthread_mutex_unlock(&_glfw.x11.eventThread.lock);
+
+    _glfw.x11.eventThread.next = 0;
 }
 
-// Sends an EWMH or ICCCM event to the window manager
+// Returns whether the event thread has read input events not yet taken
 //
-static void sendEventToWM(_GLFWwindow* window, Atom type,
-                          long a, long b, long c, long d, long e)
+static GLFWbool hasInputEvents(void)
 {
-    XEvent event = { ClientMessage };
-    event.xclient.window = window->x11.handle;
-    event.xclient.format = 32; // Data is 32-bit longs
-    event.xclient.message_type = type;
-    event.xclient.data.l[0] = a;
-    event.xclient.data.l[1] = b;
-    event.xclient.data.l[2] = c;
-    event.xclient.data.l[3] = d;
-    event.xclient.data.l[4] = e;
+    GLFWbool result;
 
-    XSendEvent(_glfw.x11.display, _glfw.x11.root,
-               False,
-               SubstructureNotifyMask | SubstructureRedirectMask,
-               &event);
+    if (!_glfw.x11.eventThread.running)
+        return GLFW_FALSE;
+
+    pthread_mutex_lock(&_glfw.x11.eventThread.lock);
+    result = _glfw.x11.eventThread.pendingCount > 0;
+    pthread_mutex_unlock(&_glfw.x11.eventThread.lock);
+
+    return result;
 }
 
-// Updates the normal hints according to the window settings
+// Retrieves the next event to be processed while the event thread is running
+// without removing it
 //
-static void updateNormalHints(_GLFWwindow* window, int width, int height)
+static GLFWbool peekQueuedEvent(XEvent* event)
 {
-    XSizeHints* hints = XAllocSizeHints();
+    GLFWbool result = GLFW_FALSE;
 
-    if (!window->monitor)
+    if (_glfw.x11.eventThread.next < _glfw.x11.eventThread.count)
     {
-        if (window->resizable)
-        {
-            if (window->minwidth != GLFW_DONT_CARE &&
-                window->minheight != GLFW_DONT_CARE)
-            {
-                hints->flags |= PMinSize;
-                hints->min_width = window->minwidth;
-                hints->min_height = window->minheight;
-            }
+        *event = _glfw.x11.eventThread.events[_glfw.x11.eventThread.next].event;
+        return GLFW_TRUE;
+    }
 
-            if (window->maxwidth != GLFW_DONT_CARE &&
-                window->maxheight != GLFW_DONT_CARE)
-            {
-                hints->flags |= PMaxSize;
-                hints->max_width = window->maxwidth;
-                hints->max_height = window->maxheight;
-            }
+    // NOTE: The display is locked so the event thread cannot move the head of
+    //       the Xlib queue to the pending array between checking both
+    XLockDisplay(_glfw.x11.display);
+    pthread_mutex_lock(&_glfw.x11.eventThread.lock);
 
-            if (window->numer != GLFW_DONT_CARE &&
-                window->denom != GLFW_DONT_CARE)
-            {
-                hints->flags |= PAspect;
-                hints->min_aspect.x = hints->max_aspect.x = window->numer;
-                hints->min_aspect.y = hints->max_aspect.y = window->denom;
-            }
-        }
-        else
-        {
-            hints->flags |= (PMinSize | PMaxSize);
-            hints->min_width  = hints->max_width  = width;
-            hints->min_height = hints->max_height = height;
-        }
+    if (_glfw.x11.eventThread.pendingCount)
+    {
+        *event = _glfw.x11.eventThread.pending[0].event;
+        result = GLFW_TRUE;
     }
 
-    hints->flags |= PWinGravity;
-    hints->win_gravity = StaticGravity;
+    pthread_mutex_unlock(&_glfw.x11.eventThread.lock);
 
-    XSetWMNormalHints(_glfw.x11.display, window->x11.handle, hints);
-    XFree(hints);
+    if (!result && XEventsQueued(_glfw.x11.display, QueuedAfterReading))
+    {
+        XPeekEvent(_glfw.x11.display, event);
+        result = GLFW_TRUE;
+    }
+
+    XUnlockDisplay(_glfw.x11.display);
+    return result;
 }
 
-// Updates the full screen status of the window
+// Removes the next event from the Xlib queue and claims its data, if any
+// This must be called with the display locked
 //
-static void updateWindowMode(_GLFWwindow* window)
+// NOTE: Xlib frees the data of any generic event not yet claimed each time an
+//       event is removed from its queue, so it is claimed here instead of when
+//       the event is processed
+//
+static void takeQueuedEvent(XEvent* event)
 {
-    if (window->monitor)
+    XNextEvent(_glfw.x11.display, event);
+
+    if (event->type == GenericEvent)
+        XGetEventData(_glfw.x11.display, &event->xcookie);
+}
+
+// Removes the next event, in the order they were received, from either the
+// input events taken from the event thread or the Xlib queue
+//
+// NOTE: The event thread only moves events from the head of the Xlib queue, so
+//       the events it has read are always processed before the Xlib queue
+//
+static GLFWbool nextQueuedEvent(XEvent* event)
+{
+    GLFWbool result = GLFW_FALSE;
+
+    // NOTE: The display is locked so the event thread cannot move the head of
+    //       the Xlib queue between taking its input events and checking it
+    XLockDisplay(_glfw.x11.display);
+
+    if (_glfw.x11.eventThread.next == _glfw.x11.eventThread.count)
+        takeInputEvents();
+
+    if (_glfw.x11.eventThread.next < _glfw.x11.eventThread.count)
     {
-        if (_glfw.x11.xinerama.available &&
-            _glfw.x11.NET_WM_FULLSCREEN_MONITORS)
-        {
-            sendEventToWM(window,
-                          _glfw.x11.NET_WM_FULLSCREEN_MONITORS,
-                          window->monitor->x11.index,
-                          window->monitor->x11.index,
-                          window->monitor->x11.index,
-                          window->monitor->x11.index,
-                          0);
-        }
+        const _GLFWinputeventX11* input =
+            _glfw.x11.eventThread.events + _glfw.x11.eventThread.next;
 
-        if (_glfw.x11.NET_WM_STATE && _glfw.x11.NET_WM_STATE_FULLSCREEN)
-        {
-            sendEventToWM(window,
-                          _glfw.x11.NET_WM_STATE,
-                          _NET_WM_STATE_ADD,
-                          _glfw.x11.NET_WM_STATE_FULLSCREEN,
-                          0, 1, 0);
-        }
-        else
-        {
-            // This is the butcher's way of removing window decorations
-            // Setting the override-redirect attribute on a window makes the
-            // window manager ignore the window completely (ICCCM, section 4)
-            // The good thing is that this makes undecorated full screen windows
-            // easy to do; the bad thing is that we have to do everything
-            // manually and some things (like iconify/restore) won't work at
-            // all, as those are tasks usually performed by the window manager
+        *event = input->event;
+        _glfw.x11.eventThread.time = input->time;
+        _glfw.x11.eventThread.next++;
+        result = GLFW_TRUE;
+    }
+    else if (XQLength(_glfw.x11.display))
+    {
+        takeQueuedEvent(event);
+        _glfw.x11.eventThread.time = 0;
+        result = GLFW_TRUE;
+    }
 
-            XSetWindowAttributes attributes;
-            attributes.override_redirect = True;
-            XChangeWindowAttributes(_glfw.x11.display,
-                                    window->x11.handle,
-                                    CWOverrideRedirect,
-                                    &attributes);
+    XUnlockDisplay(_glfw.x11.display);
+    return result;
+}
 
-            window->x11.overrideRedirect = GLFW_TRUE;
-        }
+// Moves the events already read by Xlib, up to the batch size, out of its queue
+// while holding the display lock only once
+//
+static int takeEventBatch(void)
+{
+    int count = 0;
 
-        // Enable compositor bypass
-        if (!window->x11.transparent)
-        {
-            const unsigned long value = 1;
+    XLockDisplay(_glfw.x11.display);
 
-            XChangeProperty(_glfw.x11.display,  window->x11.handle,
-                            _glfw.x11.NET_WM_BYPASS_COMPOSITOR, XA_CARDINAL, 32,
-                            PropModeReplace, (unsigned char*) &value, 1);
-        }
-    }
-    else
+    while (count < _GLFW_X11_EVENT_BATCH_SIZE && XQLength(_glfw.x11.display))
     {
-        if (_glfw.x11.xinerama.available &&
-            _glfw.x11.NET_WM_FULLSCREEN_MONITORS)
-        {
-            XDeleteProperty(_glfw.x11.display, window->x11.handle,
-                            _glfw.x11.NET_WM_FULLSCREEN_MONITORS);
-        }
-
-        if (_glfw.x11.NET_WM_STATE && _glfw.x11.NET_WM_STATE_FULLSCREEN)
-        {
-            sendEventToWM(window,
-                          _glfw.x11.NET_WM_STATE,
-                          _NET_WM_STATE_REMOVE,
-                          _glfw.x11.NET_WM_STATE_FULLSCREEN,
-                          0, 1, 0);
-        }
-        else
-        {
-            XSetWindowAttributes attributes;
-            attributes.override_redirect = False;
-            XChangeWindowAttributes(_glfw.x11.display,
-                                    window->x11.handle,
-                                    CWOverrideRedirect,
-                                    &attributes);
+        takeQueuedEvent(_glfw.x11.eventBatch.events + count);
+        count++;
+    }
 
-            window->x11.overrideRedirect = GLFW_FALSE;
-        }
+    XUnlockDisplay(_glfw.x11.display);
 
-        // Disable compositor bypass
-        if (!window->x11.transparent)
-        {
-            XDeleteProperty(_glfw.x11.display, window->x11.handle,
-                            _glfw.x11.NET_WM_BYPASS_COMPOSITOR);
-        }
-    }
+    _glfw.x11.eventBatch.count = count;
+    _glfw.x11.eventBatch.next = 0;
+    return count;
 }
 
-// Splits and translates a text/uri-list into separate file paths
-// NOTE: This function destroys the provided string
+// Returns whether the head of the Xlib queue was sent before the specified
+// event and should be processed first
 //
-static char** parseUriList(char* text, int* count)
+// NOTE: The Xlib queue is only non-empty here if events were put back, such as
+//       by XFilterEvent for input methods, or read while processing the batch
+//
+static GLFWbool precedesBatchedEvent(const XEvent* event)
 {
-    const char* prefix = "file://";
-    char** paths = NULL;
-    char* line;
-
-    *count = 0;
+    GLFWbool result = GLFW_FALSE;
 
-    while ((line = strtok(text, "\r\n")))
-    {
-        text = NULL;
+    if (!XQLength(_glfw.x11.display))
+        return GLFW_FALSE;
 
-        if (line[0] == '#')
-            continue;
+    XLockDisplay(_glfw.x11.display);
 
-        if (strncmp(line, prefix, strlen(prefix)) == 0)
-        {
-            line += strlen(prefix);
-            // TODO: Validate hostname
-            while (*line != '/')
-                line++;
-        }
+    if (XQLength(_glfw.x11.display))
+    {
+        XEvent head;
+        XPeekEvent(_glfw.x11.display, &head);
+        result = head.xany.serial < event->xany.serial;
+    }
 
-        (*count)++;
+    XUnlockDisplay(_glfw.x11.display);
+    return result;
+}
 
-        char* path = calloc(strlen(line) + 1, 1);
-        paths = realloc(paths, *count * sizeof(char*));
-        paths[*count - 1] = path;
+// Retrieves the next event to be processed without removing it
+//
+static GLFWbool peekBatchedEvent(XEvent* event)
+{
+    if (_glfw.x11.eventBatch.next < _glfw.x11.eventBatch.count)
+    {
+        const XEvent* batched =
+            _glfw.x11.eventBatch.events + _glfw.x11.eventBatch.next;
 
-        while (*line)
+        if (!precedesBatchedEvent(batched))
         {
-            if (line[0] == '%' && line[1] && line[2])
-            {
-                const char digits[3] = { line[1], line[2], '\0' };
-                *path = strtol(digits, NULL, 16);
-                line += 2;
-            }
-            else
-                *path = *line;
-
-            path++;
-            line++;
+            *event = *batched;
+            return GLFW_TRUE;
         }
     }
 
-    return paths;
+    if (!XEventsQueued(_glfw.x11.display, QueuedAfterReading))
+        return GLFW_FALSE;
+
+    XPeekEvent(_glfw.x11.display, event);
+    return GLFW_TRUE;
 }
 
-// Encode a Unicode code point to a UTF-8 stream
-// Based on cutef8 by Jeff Bezanson (Public Domain)
+// Removes the next event to be processed, taking a new batch from the Xlib
+// queue when the current one has been processed
 //
-static size_t encodeUTF8(char* s, unsigned int ch)
+static GLFWbool nextBatchedEvent(XEvent* event)
 {
-    size_t count = 0;
+    const XEvent* batched;
 
-    if (ch < 0x80)
-        s[count++] = (char) ch;
-    else if (ch < 0x800)
-    {
-        s[count++] = (ch >> 6) | 0xc0;
-        s[count++] = (ch & 0x3f) | 0x80;
-    }
-    else if (ch < 0x10000)
+    if (_glfw.x11.eventBatch.next == _glfw.x11.eventBatch.count)
     {
-        s[count++] = (ch >> 12) | 0xe0;
-        s[count++] = ((ch >> 6) & 0x3f) | 0x80;
-        s[count++] = (ch & 0x3f) | 0x80;
+        if (!takeEventBatch())
+            return GLFW_FALSE;
     }
-    else if (ch < 0x110000)
+
+    batched = _glfw.x11.eventBatch.events + _glfw.x11.eventBatch.next;
+
+    if (precedesBatchedEvent(batched))
     {
-        s[count++] = (ch >> 18) | 0xf0;
-        s[count++] = ((ch >> 12) & 0x3f) | 0x80;
-        s[count++] = ((ch >> 6) & 0x3f) | 0x80;
-        s[count++] = (ch & 0x3f) | 0x80;
+        XLockDisplay(_glfw.x11.display);
+        takeQueuedEvent(event);
+        XUnlockDisplay(_glfw.x11.display);
+        return GLFW_TRUE;
     }
 
-    return count;
+    *event = *batched;
+    _glfw.x11.eventBatch.next++;
+    return GLFW_TRUE;
 }
 
-// Decode a Unicode code point from a UTF-8 stream
-// Based on cutef8 by Jeff Bezanson (Public Domain)
+// Returns the preferred slot in the window table for the specified window XID
 //
-#if defined(X_HAVE_UTF8_STRING)
-static unsigned int decodeUTF8(const char** s)
+static int getWindowSlot(Window handle)
 {
-    unsigned int ch = 0, count = 0;
-    static const unsigned int offsets[] =
-    {
-        0x00000000u, 0x00003080u, 0x000e2080u,
-        0x03c82080u, 0xfa082080u, 0x82082080u
-    };
+    // NOTE: Multiplying by an odd constant keeps consecutive XIDs in distinct
+    //       slots while mixing higher bits into the masked ones
+    return (int) ((handle * 2654435761ul) & (_glfw.x11.windowTable.size - 1));
+}
 
-    do
+// Returns the slot in the window table that holds the specified window XID, or
+// the empty slot where it would be stored
+//
+static int findWindowSlot(Window handle)
+{
+    int i = getWindowSlot(handle);
+
+    while (_glfw.x11.windowTable.slots[i] &&
+           _glfw.x11.windowTable.slots[i]->x11.handle != handle)
     {
-        ch = (ch << 6) + (unsigned char) **s;
-        (*s)++;
-        count++;
-    } while ((**s & 0xc0) == 0x80);
+        i = (i + 1) & (_glfw.x11.windowTable.size - 1);
+    }
 
-    assert(count <= 6);
-    return ch - offsets[count - 1];
+    return i;
 }
-#endif /*X_HAVE_UTF8_STRING*/
 
-// Convert the specified Latin-1 string to UTF-8
+// Returns the window with the specified XID, or NULL if there is none
 //
-static char* convertLatin1toUTF8(const char* source)
+static _GLFWwindow* findWindow(Window handle)
 {
-    size_t size = 1;
-    const char* sp;
+    _GLFWwindow* window = _glfw.x11.windowTable.last;
 
-    for (sp = source;  *sp;  sp++)
-        size += (*sp & 0x80) ? 2 : 1;
+    if (window && window->x11.handle == handle)
+        return window;
 
-    char* target = calloc(size, 1);
-    char* tp = target;
+    if (!_glfw.x11.windowTable.count)
+        return NULL;
 
-    for (sp = source;  *sp;  sp++)
-        tp += encodeUTF8(tp, *sp);
+    window = _glfw.x11.windowTable.slots[findWindowSlot(handle)];
+    if (window)
+        _glfw.x11.windowTable.last = window;
 
-    return target;
+    return window;
 }
 
-// Updates the cursor image according to its cursor mode
+// Adds the window to the window table, growing it to keep the load factor at
+// or below one half
 //
-static void updateCursorImage(_GLFWwindow* window)
+static GLFWbool addWindowToTable(_GLFWwindow* window)
 {
-    if (window->cursorMode == GLFW_CURSOR_NORMAL)
+    if ((_glfw.x11.windowTable.count + 1) * 2 > _glfw.x11.windowTable.size)
     {
-        if (window->cursor)
+        int i;
+        _GLFWwindow** slots = _glfw.x11.windowTable.slots;
+        const int size = _glfw.x11.windowTable.size;
+
+        _glfw.x11.windowTable.size = size ? size * 2 : 16;
+        _glfw.x11.windowTable.slots =
+            calloc(_glfw.x11.windowTable.size, sizeof(_GLFWwindow*));
+        if (!_glfw.x11.windowTable.slots)
         {
-            XDefineCursor(_glfw.x11.display, window->x11.handle,
-                          window->cursor->x11.handle);
+            _glfw.x11.windowTable.slots = slots;
+            _glfw.x11.windowTable.size = size;
+            _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+            return GLFW_FALSE;
         }
-        else
-            XUndefineCursor(_glfw.x11.display, window->x11.handle);
-    }
-    else
-    {
-        XDefineCursor(_glfw.x11.display, window->x11.handle,
-                      _glfw.x11.hiddenCursorHandle);
+
+        for (i = 0;  i < size;  i++)
+        {
+            if (slots[i])
+            {
+                const int slot = findWindowSlot(slots[i]->x11.handle);
+                _glfw.x11.windowTable.slots[slot] = slots[i];
+            }
+        }
+
+        free(slots);
     }
+
+    _glfw.x11.windowTable.slots[findWindowSlot(window->x11.handle)] = window;
+    _glfw.x11.windowTable.count++;
+    return GLFW_TRUE;
 }
 
-// Enable XI2 raw mouse motion events
+// Removes the window from the window table
 //
-static void enableRawMouseMotion(_GLFWwindow* window)
+static void removeWindowFromTable(_GLFWwindow* window)
 {
-    XIEventMask em;
-    unsigned char mask[XIMaskLen(XI_RawMotion)] = { 0 };
+    int i, j;
+    const int mask = _glfw.x11.windowTable.size - 1;
 
-    em.deviceid = XIAllMasterDevices;
-    em.mask_len = sizeof(mask);
-    em.mask = mask;
-    XISetMask(mask, XI_RawMotion);
+    if (_glfw.x11.windowTable.last == window)
+        _glfw.x11.windowTable.last = NULL;
 
-    XISelectEvents(_glfw.x11.display, _glfw.x11.root, &em, 1);
+    if (!_glfw.x11.windowTable.count)
+        return;
+
+    i = findWindowSlot(window->x11.handle);
+    if (_glfw.x11.windowTable.slots[i] != window)
+        return;
+
+    _glfw.x11.windowTable.slots[i] = NULL;
+    _glfw.x11.windowTable.count--;
+
+    // Shift back any following windows that could no longer be found across
+    // the new gap, which avoids the need for tombstones
+    j = (i + 1) & mask;
+
+    while (_glfw.x11.windowTable.slots[j])
+    {
+        const int k = getWindowSlot(_glfw.x11.windowTable.slots[j]->x11.handle);
+
+        // Move the window into the gap unless its preferred slot is
+        // cyclically in (i, j]
+        if (i <= j ? (i >= k || k > j) : (i >= k && k > j))
+        {
+            _glfw.x11.windowTable.slots[i] = _glfw.x11.windowTable.slots[j];
+            _glfw.x11.windowTable.slots[j] = NULL;
+            i = j;
+        }
+
+        j = (j + 1) & mask;
+    }
 }
 
-// Disable XI2 raw mouse motion events
+// Waits until a VisibilityNotify event arrives for the specified window or the
+// timeout period elapses (ICCCM section 4.2.2)
 //
-static void disableRawMouseMotion(_GLFWwindow* window)
+static GLFWbool waitForVisibilityNotify(_GLFWwindow* window)
 {
-    XIEventMask em;
-    unsigned char mask[] = { 0 };
+    XEvent dummy;
+    double timeout = 0.1;
 
-    em.deviceid = XIAllMasterDevices;
-    em.mask_len = sizeof(mask);
-    em.mask = mask;
+    while (!XCheckTypedWindowEvent(_glfw.x11.display,
+                                   window->x11.handle,
+                                   VisibilityNotify,
+                                   &dummy))
+    {
+        if (!waitForEvent(&timeout))
+            return GLFW_FALSE;
+    }
 
-    XISelectEvents(_glfw.x11.display, _glfw.x11.root, &em, 1);
+    return GLFW_TRUE;
 }
 
-// Apply disabled cursor mode to a focused window
+// Returns whether the window is iconified
 //
-static void disableCursor(_GLFWwindow* window)
+static int getWindowState(_GLFWwindow* window)
 {
-    if (window->rawMouseMotion)
-        enableRawMouseMotion(window);
-
-    _glfw.x11.disabledCursorWindow = window;
-    _glfwPlatformGetCursorPos(window,
-                              &_glfw.x11.restoreCursorPosX,
-                              &_glfw.x11.restoreCursorPosY);
+    int result = WithdrawnState;
+    struct {
+        CARD32 state;
+        Window icon;
+    } *state = NULL;
+
+    if (_glfwGetWindowPropertyX11(window->x11.handle,
+                                  _glfw.x11.WM_STATE,
+                                  _glfw.x11.WM_STATE,
+                                  (unsigned char**) &state) >= 2)
+    {
+        result = state->state;
+    }
+
+    if (state)
+        XFree(state);
+
+    return result;
+}
+
+// Returns whether the window is maximized according to _NET_WM_STATE
+//
+static GLFWbool queryWindowMaximized(_GLFWwindow* window)
+{
+    Atom* states;
+    unsigned long i;
+    GLFWbool maximized = GLFW_FALSE;
+
+    if (!_glfw.x11.NET_WM_STATE ||
+        !_glfw.x11.NET_WM_STATE_MAXIMIZED_VERT ||
+        !_glfw.x11.NET_WM_STATE_MAXIMIZED_HORZ)
+    {
+        return maximized;
+    }
+
+    const unsigned long count =
+        _glfwGetWindowPropertyX11(window->x11.handle,
+                                  _glfw.x11.NET_WM_STATE,
+                                  XA_ATOM,
+                                  (unsigned char**) &states);
+
+    for (i = 0;  i < count;  i++)
+    {
+        if (states[i] == _glfw.x11.NET_WM_STATE_MAXIMIZED_VERT ||
+            states[i] == _glfw.x11.NET_WM_STATE_MAXIMIZED_HORZ)
+        {
+            maximized = GLFW_TRUE;
+            break;
+        }
+    }
+
+    if (states)
+        XFree(states);
+
+    return maximized;
+}
+
+// Returns the INCR transfer to the specified requestor property, if any
+//
+static _GLFWtransferX11* findTransfer(Window requestor, Atom property)
+{
+    for (int i = 0;  i < _glfw.x11.transfers.count;  i++)
+    {
+        _GLFWtransferX11* transfer = _glfw.x11.transfers.entries + i;
+        if (transfer->requestor == requestor && transfer->property == property)
+            return transfer;
+    }
+
+    return NULL;
+}
+
+// Returns whether any INCR transfer is in progress to the specified requestor
+//
+static GLFWbool hasTransfers(Window requestor)
+{
+    for (int i = 0;  i < _glfw.x11.transfers.count;  i++)
+    {
+        if (_glfw.x11.transfers.entries[i].requestor == requestor)
+            return GLFW_TRUE;
+    }
+
+    return GLFW_FALSE;
+}
+
+// Returns whether the event is a selection event
+//
+static Bool isSelectionEvent(Display* display, XEvent* event, XPointer pointer)
+{
+    if (event->type == PropertyNotify)
+    {
+        // Progress of an INCR transfer to a requestor
+        return findTransfer(event->xproperty.window,
+                            event->xproperty.atom) != NULL;
+    }
+
+    if (event->type == DestroyNotify)
+    {
+        // End of an INCR transfer to a requestor that went away
+        return hasTransfers(event->xdestroywindow.window);
+    }
+
+    if (event->xany.window != _glfw.x11.helperWindowHandle)
+        return False;
+
+    return event->type == SelectionRequest ||
+           event->type == SelectionNotify ||
+           event->type == SelectionClear;
+}
+
+// Returns whether it is a _NET_FRAME_EXTENTS event for the specified window
+//
+static Bool isFrameExtentsEvent(Display* display, XEvent* event, XPointer pointer)
+{
+    _GLFWwindow* window = (_GLFWwindow*) pointer;
+    return event->type == PropertyNotify &&
+           event->xproperty.state == PropertyNewValue &&
+           event->xproperty.window == window->x11.handle &&
+           event->xproperty.atom == _glfw.x11.NET_FRAME_EXTENTS;
+}
+
+// Returns whether it is a property event for the specified selection transfer
+//
+static Bool isSelPropNewValueNotify(Display* display, XEvent* event, XPointer pointer)
+{
+    XEvent* notification = (XEvent*) pointer;
+    return event->type == PropertyNotify &&
+           event->xproperty.state == PropertyNewValue &&
+           event->xproperty.window == notification->xselection.requestor &&
+           event->xproperty.atom == notification->xselection.property;
+}
+
+// Translates an X event modifier state mask
+//
+static int translateState(int state)
+{
+    int mods = 0;
+
+    if (state & ShiftMask)
+        mods |= GLFW_MOD_SHIFT;
+    if (state & ControlMask)
+        mods |= GLFW_MOD_CONTROL;
+    if (state & Mod1Mask)
+        mods |= GLFW_MOD_ALT;
+    if (state & Mod4Mask)
+        mods |= GLFW_MOD_SUPER;
+    if (state & LockMask)
+        mods |= GLFW_MOD_CAPS_LOCK;
+    if (state & Mod2Mask)
+        mods |= GLFW_MOD_NUM_LOCK;
+
+    return mods;
+}
+
+// Translates an X11 key code to a GLFW key token
+//
+static int translateKey(int scancode)
+{
+    // Use the pre-filled LUT (see createKeyTables() in x11_init.c)
+    if (scancode < 0 || scancode > 255)
+        return GLFW_KEY_UNKNOWN;
+
+    return _glfw.x11.keycodes[scancode];
+}
+
+// Sends an EWMH or ICCCM event to the window manager
+//
+static void sendEventToWM(_GLFWwindow* window, Atom type,
+                          long a, long b, long c, long d, long e)
+{
+    XEvent event = { ClientMessage };
+    event.xclient.window = window->x11.handle;
+    event.xclient.format = 32; // Data is 32-bit longs
+    event.xclient.message_type = type;
+    event.xclient.data.l[0] = a;
+    event.xclient.data.l[1] = b;
+    event.xclient.data.l[2] = c;
+    event.xclient.data.l[3] = d;
+    event.xclient.data.l[4] = e;
+
+    XSendEvent(_glfw.x11.display, _glfw.x11.root,
+               False,
+               SubstructureNotifyMask | SubstructureRedirectMask,
+               &event);
+}
+
+// Updates the normal hints according to the window settings
+//
+static void updateNormalHints(_GLFWwindow* window, int width, int height)
+{
+    XSizeHints* hints = XAllocSizeHints();
+
+    if (!window->monitor)
+    {
+        if (window->resizable)
+        {
+            if (window->minwidth != GLFW_DONT_CARE &&
+                window->minheight != GLFW_DONT_CARE)
+            {
+                hints->flags |= PMinSize;
+                hints->min_width = window->minwidth;
+                hints->min_height = window->minheight;
+            }
+
+            if (window->maxwidth != GLFW_DONT_CARE &&
+                window->maxheight != GLFW_DONT_CARE)
+            {
+                hints->flags |= PMaxSize;
+                hints->max_width = window->maxwidth;
+                hints->max_height = window->maxheight;
+            }
+
+            if (window->numer != GLFW_DONT_CARE &&
+                window->denom != GLFW_DONT_CARE)
+            {
+                hints->flags |= PAspect;
+                hints->min_aspect.x = hints->max_aspect.x = window->numer;
+                hints->min_aspect.y = hints->max_aspect.y = window->denom;
+            }
+        }
+        else
+        {
+            hints->flags |= (PMinSize | PMaxSize);
+            hints->min_width  = hints->max_width  = width;
+            hints->min_height = hints->max_height = height;
+        }
+    }
+
+    hints->flags |= PWinGravity;
+    hints->win_gravity = StaticGravity;
+
+    XSetWMNormalHints(_glfw.x11.display, window->x11.handle, hints);
+    XFree(hints);
+}
+
+// Updates the full screen status of the window
+//
+static void updateWindowMode(_GLFWwindow* window)
+{
+    if (window->monitor)
+    {
+        if (_glfw.x11.NET_WM_FULLSCREEN_MONITORS && _glfwLoadXineramaX11())
+        {
+            const int index = _glfwGetXineramaIndexX11(window->monitor);
+
+            sendEventToWM(window,
+                          _glfw.x11.NET_WM_FULLSCREEN_MONITORS,
+                          index, index, index, index,
+                          0);
+        }
+
+        if (_glfw.x11.NET_WM_STATE && _glfw.x11.NET_WM_STATE_FULLSCREEN)
+        {
+            sendEventToWM(window,
+                          _glfw.x11.NET_WM_STATE,
+                          _NET_WM_STATE_ADD,
+                          _glfw.x11.NET_WM_STATE_FULLSCREEN,
+                          0, 1, 0);
+        }
+        else
+        {
+            // This is the butcher's way of removing window decorations
+            // Setting the override-redirect attribute on a window makes the
+            // window manager ignore the window completely (ICCCM, section 4)
+            // The good thing is that this makes undecorated full screen windows
+            // easy to do; the bad thing is that we have to do everything
+            // manually and some things (like iconify/restore) won't work at
+            // all, as those are tasks usually performed by the window manager
+
+            XSetWindowAttributes attributes;
+            attributes.override_redirect = True;
+            XChangeWindowAttributes(_glfw.x11.display,
+                                    window->x11.handle,
+                                    CWOverrideRedirect,
+                                    &attributes);
+
+            window->x11.overrideRedirect = GLFW_TRUE;
+        }
+
+        // Enable compositor bypass
+        if (!window->x11.transparent)
+        {
+            const unsigned long value = 1;
+
+            XChangeProperty(_glfw.x11.display,  window->x11.handle,
+                            _glfw.x11.NET_WM_BYPASS_COMPOSITOR, XA_CARDINAL, 32,
+                            PropModeReplace, (unsigned char*) &value, 1);
+        }
+    }
+    else
+    {
+        if (_glfw.x11.xinerama.available &&
+            _glfw.x11.NET_WM_FULLSCREEN_MONITORS)
+        {
+            XDeleteProperty(_glfw.x11.display, window->x11.handle,
+                            _glfw.x11.NET_WM_FULLSCREEN_MONITORS);
+        }
+
+        if (_glfw.x11.NET_WM_STATE && _glfw.x11.NET_WM_STATE_FULLSCREEN)
+        {
+            sendEventToWM(window,
+                          _glfw.x11.NET_WM_STATE,
+                          _NET_WM_STATE_REMOVE,
+                          _glfw.x11.NET_WM_STATE_FULLSCREEN,
+                          0, 1, 0);
+        }
+        else
+        {
+            XSetWindowAttributes attributes;
+            attributes.override_redirect = False;
+            XChangeWindowAttributes(_glfw.x11.display,
+                                    window->x11.handle,
+                                    CWOverrideRedirect,
+                                    &attributes);
+
+            window->x11.overrideRedirect = GLFW_FALSE;
+        }
+
+        // Disable compositor bypass
+        if (!window->x11.transparent)
+        {
+            XDeleteProperty(_glfw.x11.display, window->x11.handle,
+                            _glfw.x11.NET_WM_BYPASS_COMPOSITOR);
+        }
+    }
+}
+
+// Splits and translates a text/uri-list into separate file paths
+// NOTE: This function destroys the provided string
+//
+static char** parseUriList(char* text, int* count)
+{
+    const char* prefix = "file://";
+    char** paths = NULL;
+    char* line;
+
+    *count = 0;
+
+    while ((line = strtok(text, "\r\n")))
+    {
+        text = NULL;
+
+        if (line[0] == '#')
+            continue;
+
+        if (strncmp(line, prefix, strlen(prefix)) == 0)
+        {
+            line += strlen(prefix);
+            // TODO: Validate hostname
+            while (*line != '/')
+                line++;
+        }
+
+        (*count)++;
+
+        char* path = calloc(strlen(line) + 1, 1);
+        paths = realloc(paths, *count * sizeof(char*));
+        paths[*count - 1] = path;
+
+        while (*line)
+        {
+            if (line[0] == '%' && line[1] && line[2])
+            {
+                const char digits[3] = { line[1], line[2], '\0' };
+                *path = strtol(digits, NULL, 16);
+                line += 2;
+            }
+            else
+                *path = *line;
+
+            path++;
+            line++;
+        }
+    }
+
+    return paths;
+}
+
+// Encode a Unicode code point to a UTF-8 stream
+// Based on cutef8 by Jeff Bezanson (Public Domain)
+//
+static size_t encodeUTF8(char* s, unsigned int ch)
+{
+    size_t count = 0;
+
+    if (ch < 0x80)
+        s[count++] = (char) ch;
+    else if (ch < 0x800)
+    {
+        s[count++] = (ch >> 6) | 0xc0;
+        s[count++] = (ch & 0x3f) | 0x80;
+    }
+    else if (ch < 0x10000)
+    {
+        s[count++] = (ch >> 12) | 0xe0;
+        s[count++] = ((ch >> 6) & 0x3f) | 0x80;
+        s[count++] = (ch & 0x3f) | 0x80;
+    }
+    else if (ch < 0x110000)
+    {
+        s[count++] = (ch >> 18) | 0xf0;
+        s[count++] = ((ch >> 12) & 0x3f) | 0x80;
+        s[count++] = ((ch >> 6) & 0x3f) | 0x80;
+        s[count++] = (ch & 0x3f) | 0x80;
+    }
+
+    return count;
+}
+
+// Decode a Unicode code point from a UTF-8 stream
+// Based on cutef8 by Jeff Bezanson (Public Domain)
+//
+#if defined(X_HAVE_UTF8_STRING)
+static unsigned int decodeUTF8(const char** s)
+{
+    unsigned int ch = 0, count = 0;
+    static const unsigned int offsets[] =
+    {
+        0x00000000u, 0x00003080u, 0x000e2080u,
+        0x03c82080u, 0xfa082080u, 0x82082080u
+    };
+
+    do
+    {
+        ch = (ch << 6) + (unsigned char) **s;
+        (*s)++;
+        count++;
+    } while ((**s & 0xc0) == 0x80);
+
+    assert(count <= 6);
+    return ch - offsets[count - 1];
+}
+#endif /*X_HAVE_UTF8_STRING*/
+
+// Convert the specified Latin-1 string to UTF-8
+//
+static char* convertLatin1toUTF8(const char* source)
+{
+    size_t size = 1;
+    const char* sp;
+
+    for (sp = source;  *sp;  sp++)
+        size += (*sp & 0x80) ? 2 : 1;
+
+    char* target = calloc(size, 1);
+    char* tp = target;
+
+    for (sp = source;  *sp;  sp++)
+        tp += encodeUTF8(tp, *sp);
+
+    return target;
+}
+
+// Updates the cursor image according to its cursor mode
+//
+static void updateCursorImage(_GLFWwindow* window)
+{
+    if (window->cursorMode == GLFW_CURSOR_NORMAL)
+    {
+        if (window->cursor)
+        {
+            XDefineCursor(_glfw.x11.display, window->x11.handle,
+                          window->cursor->x11.handle);
+        }
+        else
+            XUndefineCursor(_glfw.x11.display, window->x11.handle);
+    }
+    else
+    {
+        XDefineCursor(_glfw.x11.display, window->x11.handle,
+                      _glfw.x11.hiddenCursorHandle);
+    }
+}
+
+// Enable XI2 raw mouse motion events
+//
+static void enableRawMouseMotion(_GLFWwindow* window)
+{
+    XIEventMask em;
+    unsigned char mask[XIMaskLen(XI_RawMotion)] = { 0 };
+
+    em.deviceid = XIAllMasterDevices;
+    em.mask_len = sizeof(mask);
+    em.mask = mask;
+    XISetMask(mask, XI_RawMotion);
+
+    XISelectEvents(_glfw.x11.display, _glfw.x11.root, &em, 1);
+}
+
+// Disable XI2 raw mouse motion events
+//
+static void disableRawMouseMotion(_GLFWwindow* window)
+{
+    XIEventMask em;
+    unsigned char mask[] = { 0 };
+
+    em.deviceid = XIAllMasterDevices;
+    em.mask_len = sizeof(mask);
+    em.mask = mask;
+
+    XISelectEvents(_glfw.x11.display, _glfw.x11.root, &em, 1);
+}
+
+// Apply disabled cursor mode to a focused window
+//
+static void disableCursor(_GLFWwindow* window)
+{
+    if (window->rawMouseMotion)
+        enableRawMouseMotion(window);
+
+    _glfw.x11.disabledCursorWindow = window;
+    _glfwPlatformQueryCursorPos(window,
+                                &_glfw.x11.restoreCursorPosX,
+                                &_glfw.x11.restoreCursorPosY);
     updateCursorImage(window);
     _glfwCenterCursorInContentArea(window);
     XGrabPointer(_glfw.x11.display, window->x11.handle, True,
@@ -643,10 +1257,14 @@ static GLFWbool createNativeWindow(_GLFWwindow* window,
         return GLFW_FALSE;
     }
 
-    XSaveContext(_glfw.x11.display,
-                 window->x11.handle,
-                 _glfw.x11.context,
-                 (XPointer) window);
+    if (!addWindowToTable(window))
+        return GLFW_FALSE;
+
+    if (_glfwLoadPresentX11())
+    {
+        XPresentSelectInput(_glfw.x11.display, window->x11.handle,
+                            PresentCompleteNotifyMask);
+    }
 
     if (!wndconfig->decorated)
         _glfwPlatformSetWindowDecorated(window, GLFW_FALSE);
@@ -782,32 +1400,324 @@ static GLFWbool createNativeWindow(_GLFWwindow* window,
                                    NULL);
     }
 
-    if (window->x11.ic)
-    {
-        unsigned long filter = 0;
-        if (XGetICValues(window->x11.ic, XNFilterEvents, &filter, NULL) == NULL)
-            XSelectInput(_glfw.x11.display, window->x11.handle, wa.event_mask | filter);
-    }
+    if (window->x11.ic)
+    {
+        unsigned long filter = 0;
+        if (XGetICValues(window->x11.ic, XNFilterEvents, &filter, NULL) == NULL)
+            XSelectInput(_glfw.x11.display, window->x11.handle, wa.event_mask | filter);
+    }
+
+    // The geometry is kept up to date from ConfigureNotify from here on
+    window->x11.xpos = 0;
+    window->x11.ypos = 0;
+    window->x11.width = width;
+    window->x11.height = height;
+
+    // The cursor position is kept up to date from pointer events from here on
+    double cursorX, cursorY;
+    _glfwPlatformQueryCursorPos(window, &cursorX, &cursorY);
+    window->x11.lastCursorPosX = (int) cursorX;
+    window->x11.lastCursorPosY = (int) cursorY;
+
+    return GLFW_TRUE;
+}
+
+// Returns the largest number of bytes written to a selection property at once
+//
+static size_t getMaxSelectionChunk(void)
+{
+    // Leave room for the header of the ChangeProperty request
+    const size_t limit = (size_t) XMaxRequestSize(_glfw.x11.display) * 4 - 32;
+
+    if (limit < _GLFW_X11_PROPERTY_CHUNK * 4)
+        return limit;
+    else
+        return _GLFW_X11_PROPERTY_CHUNK * 4;
+}
+
+// Returns whether the specified target is one of the usual names for UTF-8 text
+//
+static GLFWbool isUTF8TextTarget(Atom target)
+{
+    return target == _glfw.x11.UTF8_STRING ||
+           target == _glfw.x11.text_plain_utf8 ||
+           target == _glfw.x11.text_plain;
+}
+
+// Returns the size, in bytes, of the data offered for the specified selection
+//
+static size_t getSelectionDataSize(Atom selection)
+{
+    const char* string;
+
+    if (selection == _glfw.x11.PRIMARY)
+        string = _glfw.x11.primarySelectionString;
+    else if (_glfw.x11.clipboardSource.callback)
+        return _glfw.x11.clipboardSource.size;
+    else
+        string = _glfw.x11.clipboardString;
+
+    if (string)
+        return strlen(string);
+    else
+        return 0;
+}
+
+// Retrieves at most count bytes of the data offered for the specified
+// selection, starting at the specified offset
+//
+static const unsigned char* readSelectionData(Atom selection,
+                                              size_t offset,
+                                              size_t size,
+                                              size_t* count)
+{
+    const char* string;
+
+    if (offset >= size)
+    {
+        *count = 0;
+        return NULL;
+    }
+
+    if (*count > size - offset)
+        *count = size - offset;
+
+    if (selection == _glfw.x11.PRIMARY)
+        string = _glfw.x11.primarySelectionString;
+    else if (_glfw.x11.clipboardSource.callback)
+    {
+        size_t written;
+
+        if (_glfw.x11.transfers.bufferSize < *count)
+        {
+            unsigned char* buffer = realloc(_glfw.x11.transfers.buffer, *count);
+            if (!buffer)
+            {
+                _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+                *count = 0;
+                return NULL;
+            }
+
+            _glfw.x11.transfers.buffer = buffer;
+            _glfw.x11.transfers.bufferSize = *count;
+        }
+
+        written = _glfw.x11.clipboardSource.callback(_glfw.x11.transfers.buffer,
+                                                     offset,
+                                                     *count,
+                                                     _glfw.x11.clipboardSource.user);
+        if (written < *count)
+            *count = written;
+
+        return _glfw.x11.transfers.buffer;
+    }
+    else
+        string = _glfw.x11.clipboardString;
+
+    return (const unsigned char*) string + offset;
+}
+
+// Starts an INCR transfer of the data offered for the specified selection
+//
+static GLFWbool beginTransfer(Window requestor,
+                              Atom property,
+                              Atom target,
+                              Atom selection,
+                              size_t size)
+{
+    _GLFWtransferX11* transfer = findTransfer(requestor, property);
+    const long lowerBound = size < 0x7fffffff ? (long) size : 0x7fffffff;
+
+    if (!transfer)
+    {
+        _GLFWtransferX11* entries = realloc(_glfw.x11.transfers.entries,
+                                            sizeof(_GLFWtransferX11) *
+                                            (_glfw.x11.transfers.count + 1));
+        if (!entries)
+        {
+            _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+            return GLFW_FALSE;
+        }
+
+        _glfw.x11.transfers.entries = entries;
+        transfer = entries + _glfw.x11.transfers.count++;
+    }
+
+    transfer->requestor = requestor;
+    transfer->property = property;
+    transfer->target = target;
+    transfer->selection = selection;
+    transfer->size = size;
+    transfer->offset = 0;
+
+    // NOTE: The requestor deleting the INCR property is what asks for the
+    //       first part, so this must be selected before the reply is sent
+    // NOTE: Its destruction is also selected, as no further events arrive
+    //       for a transfer to a destroyed requestor
+    XSelectInput(_glfw.x11.display, requestor,
+                 PropertyChangeMask | StructureNotifyMask);
+    XChangeProperty(_glfw.x11.display,
+                    requestor,
+                    property,
+                    _glfw.x11.INCR,
+                    32,
+                    PropModeReplace,
+                    (unsigned char*) &lowerBound,
+                    1);
+
+    return GLFW_TRUE;
+}
+
+// Removes the specified INCR transfer
+//
+static void endTransfer(_GLFWtransferX11* transfer)
+{
+    const Window requestor = transfer->requestor;
+
+    *transfer = _glfw.x11.transfers.entries[--_glfw.x11.transfers.count];
+
+    if (hasTransfers(requestor))
+        return;
+
+    // The requestor may already have been destroyed
+    _glfwGrabErrorHandlerX11();
+    XSelectInput(_glfw.x11.display, requestor, NoEventMask);
+    _glfwReleaseErrorHandlerX11();
+}
+
+// Abandons the INCR transfers of the specified selection
+//
+static void cancelTransfers(Atom selection)
+{
+    for (int i = _glfw.x11.transfers.count - 1;  i >= 0;  i--)
+    {
+        if (_glfw.x11.transfers.entries[i].selection == selection)
+            endTransfer(_glfw.x11.transfers.entries + i);
+    }
+}
+
+// Ends the INCR transfers to a requestor that has been destroyed, so its XID
+// cannot be fed stale data if it is reused
+//
+static void handleTransferDestroy(const XDestroyWindowEvent* event)
+{
+    for (int i = _glfw.x11.transfers.count - 1;  i >= 0;  i--)
+    {
+        if (_glfw.x11.transfers.entries[i].requestor == event->window)
+            endTransfer(_glfw.x11.transfers.entries + i);
+    }
+}
+
+// Sends the next part of an INCR transfer once the requestor has deleted the
+// previous one, returning whether the event belongs to a transfer
+//
+static GLFWbool handleTransferProperty(const XPropertyEvent* event)
+{
+    size_t count, requested;
+    const unsigned char* data;
+    _GLFWtransferX11* transfer = findTransfer(event->window, event->atom);
+    if (!transfer)
+        return GLFW_FALSE;
+
+    // New values are the parts written by us, which may also be awaited by
+    // a clipboard request of our own on the same property
+    if (event->state != PropertyDelete)
+        return GLFW_FALSE;
+
+    requested = getMaxSelectionChunk();
+    if (requested > transfer->size - transfer->offset)
+        requested = transfer->size - transfer->offset;
+
+    count = requested;
+    data = readSelectionData(transfer->selection,
+                             transfer->offset,
+                             transfer->size,
+                             &count);
+
+    // A short read means the data ended early, so the next part is the last
+    if (count < requested)
+        transfer->size = transfer->offset + count;
+
+    // The requestor may have been destroyed mid-transfer
+    _glfwGrabErrorHandlerX11();
+    XChangeProperty(_glfw.x11.display,
+                    transfer->requestor,
+                    transfer->property,
+                    transfer->target,
+                    8,
+                    PropModeReplace,
+                    data,
+                    (int) count);
+    _glfwReleaseErrorHandlerX11();
+
+    // The transfer is complete once a zero-length part has been written
+    if (_glfw.x11.errorCode != Success || count == 0)
+        endTransfer(transfer);
+    else
+        transfer->offset += count;
+
+    return GLFW_TRUE;
+}
+
+// Writes the data offered for the specified selection to the requestor
+// property, starting an INCR transfer if it does not fit in a single request
+//
+static GLFWbool writeSelectionData(Window requestor,
+                                   Atom property,
+                                   Atom target,
+                                   Atom selection)
+{
+    size_t count;
+    const unsigned char* data;
+    const size_t size = getSelectionDataSize(selection);
 
-    _glfwPlatformGetWindowPos(window, &window->x11.xpos, &window->x11.ypos);
-    _glfwPlatformGetWindowSize(window, &window->x11.width, &window->x11.height);
+    if (size > getMaxSelectionChunk())
+        return beginTransfer(requestor, property, target, selection, size);
+
+    count = size;
+    data = readSelectionData(selection, 0, size, &count);
+
+    XChangeProperty(_glfw.x11.display,
+                    requestor,
+                    property,
+                    target,
+                    8,
+                    PropModeReplace,
+                    data,
+                    (int) count);
 
     return GLFW_TRUE;
 }
 
+// Releases the application clipboard data source, if any
+//
+static void releaseClipboardSource(void)
+{
+    const GLFWclipboardsourcefun callback = _glfw.x11.clipboardSource.callback;
+    void* user = _glfw.x11.clipboardSource.user;
+
+    if (!callback)
+        return;
+
+    memset(&_glfw.x11.clipboardSource, 0, sizeof(_glfw.x11.clipboardSource));
+    callback(NULL, 0, 0, user);
+}
+
 // Set the specified property to the selection converted to the requested target
 //
 static Atom writeTargetToProperty(const XSelectionRequestEvent* request)
 {
     int i;
-    char* selectionString = NULL;
-    const Atom formats[] = { _glfw.x11.UTF8_STRING, XA_STRING };
-    const int formatCount = sizeof(formats) / sizeof(formats[0]);
+    Atom formats[] = { _glfw.x11.UTF8_STRING, XA_STRING };
+    int formatCount = sizeof(formats) / sizeof(formats[0]);
 
-    if (request->selection == _glfw.x11.PRIMARY)
-        selectionString = _glfw.x11.primarySelectionString;
-    else
-        selectionString = _glfw.x11.clipboardString;
+    if (request->selection == _glfw.x11.CLIPBOARD &&
+        _glfw.x11.clipboardSource.callback)
+    {
+        // The application offers a single target of its own
+        formats[0] = _glfw.x11.clipboardSource.target;
+        formatCount = 1;
+    }
 
     if (request->property == None)
     {
@@ -822,8 +1732,8 @@ static Atom writeTargetToProperty(const XSelectionRequestEvent* request)
 
         const Atom targets[] = { _glfw.x11.TARGETS,
                                  _glfw.x11.MULTIPLE,
-                                 _glfw.x11.UTF8_STRING,
-                                 XA_STRING };
+                                 formats[0],
+                                 formats[1] };
 
         XChangeProperty(_glfw.x11.display,
                         request->requestor,
@@ -832,7 +1742,7 @@ static Atom writeTargetToProperty(const XSelectionRequestEvent* request)
                         32,
                         PropModeReplace,
                         (unsigned char*) targets,
-                        sizeof(targets) / sizeof(targets[0]));
+                        2 + formatCount);
 
         return request->property;
     }
@@ -859,19 +1769,14 @@ static Atom writeTargetToProperty(const XSelectionRequestEvent* request)
                     break;
             }
 
-            if (j < formatCount)
+            if (j == formatCount ||
+                !writeSelectionData(request->requestor,
+                                    targets[i + 1],
+                                    targets[i],
+                                    request->selection))
             {
-                XChangeProperty(_glfw.x11.display,
-                                request->requestor,
-                                targets[i + 1],
-                                targets[i],
-                                8,
-                                PropModeReplace,
-                                (unsigned char *) selectionString,
-                                strlen(selectionString));
-            }
-            else
                 targets[i + 1] = None;
+            }
         }
 
         XChangeProperty(_glfw.x11.display,
@@ -913,14 +1818,13 @@ static Atom writeTargetToProperty(const XSelectionRequestEvent* request)
         {
             // The requested target is one we support
 
-            XChangeProperty(_glfw.x11.display,
-                            request->requestor,
-                            request->property,
-                            request->target,
-                            8,
-                            PropModeReplace,
-                            (unsigned char *) selectionString,
-                            strlen(selectionString));
+            if (!writeSelectionData(request->requestor,
+                                    request->property,
+                                    request->target,
+                                    request->selection))
+            {
+                return None;
+            }
 
             return request->property;
         }
@@ -933,6 +1837,8 @@ static Atom writeTargetToProperty(const XSelectionRequestEvent* request)
 
 static void handleSelectionClear(XEvent* event)
 {
+    cancelTransfers(event->xselectionclear.selection);
+
     if (event->xselectionclear.selection == _glfw.x11.PRIMARY)
     {
         free(_glfw.x11.primarySelectionString);
@@ -942,6 +1848,7 @@ static void handleSelectionClear(XEvent* event)
     {
         free(_glfw.x11.clipboardString);
         _glfw.x11.clipboardString = NULL;
+        releaseClipboardSource();
     }
 }
 
@@ -979,125 +1886,413 @@ static const char* getSelectionString(Atom selection)
         return *selectionString;
     }
 
-    free(*selectionString);
-    *selectionString = NULL;
+    free(*selectionString);
+    *selectionString = NULL;
+
+    for (size_t i = 0;  i < targetCount;  i++)
+    {
+        char* data;
+        Atom actualType;
+        int actualFormat;
+        unsigned long itemCount, bytesAfter;
+        XEvent notification, dummy;
+
+        XConvertSelection(_glfw.x11.display,
+                          selection,
+                          targets[i],
+                          _glfw.x11.GLFW_SELECTION,
+                          _glfw.x11.helperWindowHandle,
+                          CurrentTime);
+
+        while (!XCheckTypedWindowEvent(_glfw.x11.display,
+                                       _glfw.x11.helperWindowHandle,
+                                       SelectionNotify,
+                                       &notification))
+        {
+            waitForEvent(NULL);
+        }
+
+        if (notification.xselection.property == None)
+            continue;
+
+        XCheckIfEvent(_glfw.x11.display,
+                      &dummy,
+                      isSelPropNewValueNotify,
+                      (XPointer) &notification);
+
+        XGetWindowProperty(_glfw.x11.display,
+                           notification.xselection.requestor,
+                           notification.xselection.property,
+                           0,
+                           LONG_MAX,
+                           True,
+                           AnyPropertyType,
+                           &actualType,
+                           &actualFormat,
+                           &itemCount,
+                           &bytesAfter,
+                           (unsigned char**) &data);
+
+        if (actualType == _glfw.x11.INCR)
+        {
+            size_t size = 1;
+            char* string = NULL;
+
+            for (;;)
+            {
+                while (!XCheckIfEvent(_glfw.x11.display,
+                                      &dummy,
+                                      isSelPropNewValueNotify,
+                                      (XPointer) &notification))
+                {
+                    waitForEvent(NULL);
+                }
+
+                XFree(data);
+                XGetWindowProperty(_glfw.x11.display,
+                                   notification.xselection.requestor,
+                                   notification.xselection.property,
+                                   0,
+                                   LONG_MAX,
+                                   True,
+                                   AnyPropertyType,
+                                   &actualType,
+                                   &actualFormat,
+                                   &itemCount,
+                                   &bytesAfter,
+                                   (unsigned char**) &data);
+
+                if (itemCount)
+                {
+                    size += itemCount;
+                    string = realloc(string, size);
+                    string[size - itemCount - 1] = '\0';
+                    strcat(string, data);
+                }
+
+                if (!itemCount)
+                {
+                    if (targets[i] == XA_STRING)
+                    {
+                        *selectionString = convertLatin1toUTF8(string);
+                        free(string);
+                    }
+                    else
+                        *selectionString = string;
+
+                    break;
+                }
+            }
+        }
+        else if (actualType == targets[i])
+        {
+            if (targets[i] == XA_STRING)
+                *selectionString = convertLatin1toUTF8(data);
+            else
+                *selectionString = _glfw_strdup(data);
+        }
+
+        XFree(data);
+
+        if (*selectionString)
+            break;
+    }
+
+    if (!*selectionString)
+    {
+        _glfwInputError(GLFW_FORMAT_UNAVAILABLE,
+                        "X11: Failed to convert selection to string");
+    }
+
+    return *selectionString;
+}
+
+// Returns the asynchronous clipboard request using the specified requestor
+//
+static _GLFWclipboardrequestX11* findClipboardRequest(Window requestor)
+{
+    for (int i = 0;  i < _glfw.x11.clipboardRequests.count;  i++)
+    {
+        _GLFWclipboardrequestX11* request = _glfw.x11.clipboardRequests.entries + i;
+        if (request->requestor == requestor)
+            return request;
+    }
+
+    return NULL;
+}
+
+// Appends part of the reply to an asynchronous clipboard request
+//
+static void appendClipboardRequestData(_GLFWclipboardrequestX11* request,
+                                       const char* data, size_t size)
+{
+    char* buffer = realloc(request->data, request->size + size + 1);
+    if (!buffer)
+    {
+        _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+        return;
+    }
+
+    memcpy(buffer + request->size, data, size);
+    buffer[request->size + size] = '\0';
+    request->data = buffer;
+    request->size += size;
+}
+
+// Passes the string of an asynchronous clipboard request already removed from
+// the request list to its callback
+//
+static void finishClipboardRequest(_GLFWclipboardrequestX11* request,
+                                   GLFWbool success)
+{
+    char* string = NULL;
+
+    if (success)
+    {
+        if (request->target == XA_STRING)
+        {
+            string = convertLatin1toUTF8(request->data ? request->data : "");
+            free(request->data);
+        }
+        else if (request->data)
+            string = request->data;
+        else
+            string = _glfw_strdup("");
+    }
+    else
+    {
+        free(request->data);
+        _glfwInputError(GLFW_FORMAT_UNAVAILABLE,
+                        "X11: Failed to convert selection to string");
+    }
+
+    if (request->requestor)
+        XDestroyWindow(_glfw.x11.display, request->requestor);
+
+    request->callback(string, request->user);
+    free(string);
+}
+
+// Removes the specified asynchronous clipboard request and passes its string
+// to the callback
+//
+static void completeClipboardRequest(_GLFWclipboardrequestX11* request,
+                                     GLFWbool success)
+{
+    _GLFWclipboardrequestX11 completed = *request;
+
+    // The callback may issue another request, so remove this one first
+    *request = _glfw.x11.clipboardRequests.entries[--_glfw.x11.clipboardRequests.count];
+
+    finishClipboardRequest(&completed, success);
+}
+
+// Completes the asynchronous clipboard requests answered from our own
+// clipboard contents, in the order they were made
+//
+static void completeLocalClipboardRequests(void)
+{
+    int i, count = 0, remaining = 0;
+    _GLFWclipboardrequestX11* local;
+
+    for (i = 0;  i < _glfw.x11.clipboardRequests.count;  i++)
+    {
+        if (!_glfw.x11.clipboardRequests.entries[i].requestor)
+            count++;
+    }
+
+    if (!count)
+        return;
+
+    local = calloc(count, sizeof(_GLFWclipboardrequestX11));
+    if (!local)
+    {
+        _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+        return;
+    }
+
+    // The callbacks may issue other requests, so remove these ones first
+    count = 0;
+
+    for (i = 0;  i < _glfw.x11.clipboardRequests.count;  i++)
+    {
+        const _GLFWclipboardrequestX11* request =
+            _glfw.x11.clipboardRequests.entries + i;
+
+        if (request->requestor)
+            _glfw.x11.clipboardRequests.entries[remaining++] = *request;
+        else
+            local[count++] = *request;
+    }
+
+    _glfw.x11.clipboardRequests.count = remaining;
+
+    for (i = 0;  i < count;  i++)
+        finishClipboardRequest(local + i, local[i].data != NULL);
+
+    free(local);
+}
+
+// Handles a reply to an asynchronous clipboard request, returning whether the
+// event belongs to one
+//
+static GLFWbool handleClipboardRequestEvent(const XEvent* event)
+{
+    _GLFWclipboardrequestX11* request;
+    char* data = NULL;
+    Atom actualType = None;
+    int actualFormat;
+    unsigned long itemCount = 0, bytesAfter;
+
+    if (event->type == SelectionNotify)
+        request = findClipboardRequest(event->xselection.requestor);
+    else if (event->type == PropertyNotify)
+        request = findClipboardRequest(event->xproperty.window);
+    else
+        return GLFW_FALSE;
+
+    if (!request)
+        return GLFW_FALSE;
+
+    if (event->type == SelectionNotify)
+    {
+        if (event->xselection.property == None)
+        {
+            if (request->target == _glfw.x11.UTF8_STRING)
+            {
+                // Fall back to Latin-1 like glfwGetClipboardString does
+                request->target = XA_STRING;
+                XConvertSelection(_glfw.x11.display,
+                                  _glfw.x11.CLIPBOARD,
+                                  request->target,
+                                  _glfw.x11.GLFW_SELECTION,
+                                  request->requestor,
+                                  CurrentTime);
+            }
+            else
+                completeClipboardRequest(request, GLFW_FALSE);
+
+            return GLFW_TRUE;
+        }
+    }
+    else
+    {
+        // Only new parts of an INCR transfer matter, not our own deletions or
+        // the INCR property itself arriving ahead of the notification
+        if (!request->incremental ||
+            event->xproperty.state != PropertyNewValue ||
+            event->xproperty.atom != _glfw.x11.GLFW_SELECTION)
+        {
+            return GLFW_TRUE;
+        }
+    }
+
+    XGetWindowProperty(_glfw.x11.display,
+                       request->requestor,
+                       _glfw.x11.GLFW_SELECTION,
+                       0,
+                       LONG_MAX,
+                       True,
+                       AnyPropertyType,
+                       &actualType,
+                       &actualFormat,
+                       &itemCount,
+                       &bytesAfter,
+                       (unsigned char**) &data);
+
+    if (request->incremental)
+    {
+        // The transfer ends with a zero-length part
+        if (itemCount)
+            appendClipboardRequestData(request, data, itemCount);
+        else
+            completeClipboardRequest(request, GLFW_TRUE);
+    }
+    else if (actualType == _glfw.x11.INCR)
+    {
+        // Deleting the INCR property asks the owner for the first part
+        request->incremental = GLFW_TRUE;
+    }
+    else if (actualType == request->target)
+    {
+        appendClipboardRequestData(request, data, itemCount);
+        completeClipboardRequest(request, GLFW_TRUE);
+    }
+    else
+        completeClipboardRequest(request, GLFW_FALSE);
+
+    if (data)
+        XFree(data);
+
+    return GLFW_TRUE;
+}
+
+// Passes the contents of a selection property to the callback in chunks and
+// then deletes it, storing the number of bytes read
+//
+static GLFWbool streamSelectionProperty(Window window, Atom property,
+                                        GLFWclipboarddatafun callback,
+                                        void* user, size_t* total)
+{
+    long offset = 0;
 
-    for (size_t i = 0;  i < targetCount;  i++)
+    *total = 0;
+
+    for (;;)
     {
-        char* data;
+        unsigned char* data;
         Atom actualType;
         int actualFormat;
         unsigned long itemCount, bytesAfter;
-        XEvent notification, dummy;
-
-        XConvertSelection(_glfw.x11.display,
-                          selection,
-                          targets[i],
-                          _glfw.x11.GLFW_SELECTION,
-                          _glfw.x11.helperWindowHandle,
-                          CurrentTime);
+        size_t size;
 
-        while (!XCheckTypedWindowEvent(_glfw.x11.display,
-                                       _glfw.x11.helperWindowHandle,
-                                       SelectionNotify,
-                                       &notification))
+        if (XGetWindowProperty(_glfw.x11.display,
+                               window,
+                               property,
+                               offset,
+                               _GLFW_X11_PROPERTY_CHUNK,
+                               False,
+                               AnyPropertyType,
+                               &actualType,
+                               &actualFormat,
+                               &itemCount,
+                               &bytesAfter,
+                               &data) != Success)
         {
-            waitForEvent(NULL);
+            _glfwInputError(GLFW_PLATFORM_ERROR,
+                            "X11: Failed to read selection property");
+            return GLFW_FALSE;
         }
 
-        if (notification.xselection.property == None)
-            continue;
-
-        XCheckIfEvent(_glfw.x11.display,
-                      &dummy,
-                      isSelPropNewValueNotify,
-                      (XPointer) &notification);
-
-        XGetWindowProperty(_glfw.x11.display,
-                           notification.xselection.requestor,
-                           notification.xselection.property,
-                           0,
-                           LONG_MAX,
-                           True,
-                           AnyPropertyType,
-                           &actualType,
-                           &actualFormat,
-                           &itemCount,
-                           &bytesAfter,
-                           (unsigned char**) &data);
+        if (actualType == None)
+            return GLFW_TRUE;
 
-        if (actualType == _glfw.x11.INCR)
+        // NOTE: Xlib returns 32-bit items as longs, which may be wider
+        if (actualFormat == 32)
         {
-            size_t size = 1;
-            char* string = NULL;
-
-            for (;;)
-            {
-                while (!XCheckIfEvent(_glfw.x11.display,
-                                      &dummy,
-                                      isSelPropNewValueNotify,
-                                      (XPointer) &notification))
-                {
-                    waitForEvent(NULL);
-                }
-
-                XFree(data);
-                XGetWindowProperty(_glfw.x11.display,
-                                   notification.xselection.requestor,
-                                   notification.xselection.property,
-                                   0,
-                                   LONG_MAX,
-                                   True,
-                                   AnyPropertyType,
-                                   &actualType,
-                                   &actualFormat,
-                                   &itemCount,
-                                   &bytesAfter,
-                                   (unsigned char**) &data);
-
-                if (itemCount)
-                {
-                    size += itemCount;
-                    string = realloc(string, size);
-                    string[size - itemCount - 1] = '\0';
-                    strcat(string, data);
-                }
+            for (unsigned long i = 0;  i < itemCount;  i++)
+                ((uint32_t*) data)[i] = (uint32_t) ((long*) data)[i];
+        }
 
-                if (!itemCount)
-                {
-                    if (targets[i] == XA_STRING)
-                    {
-                        *selectionString = convertLatin1toUTF8(string);
-                        free(string);
-                    }
-                    else
-                        *selectionString = string;
+        size = itemCount * (actualFormat / 8);
 
-                    break;
-                }
-            }
-        }
-        else if (actualType == targets[i])
+        if (size && !callback(data, size, user))
         {
-            if (targets[i] == XA_STRING)
-                *selectionString = convertLatin1toUTF8(data);
-            else
-                *selectionString = _glfw_strdup(data);
+            XFree(data);
+            return GLFW_FALSE;
         }
 
         XFree(data);
 
-        if (*selectionString)
-            break;
-    }
+        *total += size;
+        offset += size / 4;
 
-    if (!*selectionString)
-    {
-        _glfwInputError(GLFW_FORMAT_UNAVAILABLE,
-                        "X11: Failed to convert selection to string");
+        if (!bytesAfter)
+            break;
     }
 
-    return *selectionString;
+    XDeleteProperty(_glfw.x11.display, window, property);
+    return GLFW_TRUE;
 }
 
 // Make the specified window and its video mode active on its monitor
@@ -1146,20 +2341,325 @@ static void releaseMonitor(_GLFWwindow* window)
     if (window->monitor->window != window)
         return;
 
-    _glfwInputMonitorWindow(window->monitor, NULL);
-    _glfwRestoreVideoModeX11(window->monitor);
+    _glfwInputMonitorWindow(window->monitor, NULL);
+    _glfwRestoreVideoModeX11(window->monitor);
+
+    _glfw.x11.saver.count--;
+
+    if (_glfw.x11.saver.count == 0)
+    {
+        // Restore old screen saver settings
+        XSetScreenSaver(_glfw.x11.display,
+                        _glfw.x11.saver.timeout,
+                        _glfw.x11.saver.interval,
+                        _glfw.x11.saver.blanking,
+                        _glfw.x11.saver.exposure);
+    }
+}
+
+// Returns whether the event is the completion of a shared memory transfer from
+// the specified segment
+//
+static Bool isShmCompletionEvent(Display* display, XEvent* event, XPointer pointer)
+{
+    return event->type == _glfw.x11.xshm.eventBase + ShmCompletion &&
+           ((XShmCompletionEvent*) event)->shmseg == *((ShmSeg*) pointer);
+}
+
+// Marks the pixel buffer read by the completed transfer as available
+//
+static void handleShmCompletion(_GLFWwindow* window,
+                                const XShmCompletionEvent* event)
+{
+    int i;
+
+    for (i = 0;  i < window->x11.pixels.count;  i++)
+    {
+        if (window->x11.pixels.shminfo[i].shmseg == event->shmseg)
+            window->x11.pixels.busy[i] = GLFW_FALSE;
+    }
+}
+
+// Waits for the server to finish reading the specified pixel buffer
+//
+static void waitForPixelBuffer(_GLFWwindow* window, int index)
+{
+    int i;
+    XEvent dummy;
+    ShmSeg shmseg = window->x11.pixels.shminfo[index].shmseg;
+
+    if (!window->x11.pixels.busy[index])
+        return;
+
+    // NOTE: The completion may already have been moved out of the Xlib queue
+    //       if this is called while events are being processed
+    for (i = _glfw.x11.eventBatch.next;  i < _glfw.x11.eventBatch.count;  i++)
+    {
+        XEvent* event = _glfw.x11.eventBatch.events + i;
+
+        if (isShmCompletionEvent(_glfw.x11.display, event, (XPointer) &shmseg))
+        {
+            memmove(event, event + 1,
+                    (_glfw.x11.eventBatch.count - i - 1) * sizeof(XEvent));
+            _glfw.x11.eventBatch.count--;
+            window->x11.pixels.busy[index] = GLFW_FALSE;
+            return;
+        }
+    }
+
+    XIfEvent(_glfw.x11.display, &dummy, isShmCompletionEvent, (XPointer) &shmseg);
+    window->x11.pixels.busy[index] = GLFW_FALSE;
+}
+
+// Creates a pixel buffer image in a segment shared with the server
+//
+static GLFWbool createShmImage(_GLFWwindow* window, int index,
+                               Visual* visual, int depth,
+                               int width, int height)
+{
+    XImage* image;
+    XShmSegmentInfo* shminfo = window->x11.pixels.shminfo + index;
+
+    image = XShmCreateImage(_glfw.x11.display, visual, depth, ZPixmap,
+                            NULL, shminfo, width, height);
+    if (!image)
+        return GLFW_FALSE;
+
+    shminfo->shmid = shmget(IPC_PRIVATE, image->bytes_per_line * image->height,
+                            IPC_CREAT | 0600);
+    if (shminfo->shmid == -1)
+    {
+        XDestroyImage(image);
+        return GLFW_FALSE;
+    }
+
+    shminfo->shmaddr = shmat(shminfo->shmid, NULL, 0);
+    if (shminfo->shmaddr == (char*) -1)
+    {
+        shmctl(shminfo->shmid, IPC_RMID, NULL);
+        shminfo->shmaddr = NULL;
+        XDestroyImage(image);
+        return GLFW_FALSE;
+    }
+
+    shminfo->readOnly = True;
+
+    // NOTE: Attaching fails if the server is on another machine
+    _glfwGrabErrorHandlerX11();
+    XShmAttach(_glfw.x11.display, shminfo);
+    XSync(_glfw.x11.display, False);
+    _glfwReleaseErrorHandlerX11();
+
+    // The segment is destroyed once both sides have detached from it
+    shmctl(shminfo->shmid, IPC_RMID, NULL);
+
+    if (_glfw.x11.errorCode != Success)
+    {
+        shmdt(shminfo->shmaddr);
+        shminfo->shmaddr = NULL;
+        XDestroyImage(image);
+        return GLFW_FALSE;
+    }
+
+    image->data = shminfo->shmaddr;
+    window->x11.pixels.images[index] = image;
+    return GLFW_TRUE;
+}
+
+// Destroys the pixel buffers of the specified window
+//
+static void destroyPixelBuffers(_GLFWwindow* window)
+{
+    int i;
+
+    for (i = 0;  i < 2;  i++)
+    {
+        XShmSegmentInfo* shminfo = window->x11.pixels.shminfo + i;
+
+        if (!window->x11.pixels.images[i])
+            continue;
+
+        if (shminfo->shmaddr)
+        {
+            XShmDetach(_glfw.x11.display, shminfo);
+            shmdt(shminfo->shmaddr);
+            window->x11.pixels.images[i]->data = NULL;
+        }
+
+        XDestroyImage(window->x11.pixels.images[i]);
+    }
+
+    if (window->x11.pixels.gc)
+        XFreeGC(_glfw.x11.display, window->x11.pixels.gc);
+
+    memset(&window->x11.pixels, 0, sizeof(window->x11.pixels));
+}
+
+// Creates the pixel buffers of the specified window, using shared memory if
+// the server supports it
+//
+static GLFWbool createPixelBuffers(_GLFWwindow* window, int width, int height)
+{
+    XWindowAttributes attribs;
+
+    XGetWindowAttributes(_glfw.x11.display, window->x11.handle, &attribs);
+
+    if (attribs.visual->red_mask != 0xff0000 ||
+        attribs.visual->green_mask != 0xff00 ||
+        attribs.visual->blue_mask != 0xff)
+    {
+        _glfwInputError(GLFW_FORMAT_UNAVAILABLE,
+                        "X11: Window visual does not use 32-bit pixels");
+        return GLFW_FALSE;
+    }
+
+    if (_glfwLoadXshmX11())
+    {
+        if (createShmImage(window, 0, attribs.visual, attribs.depth,
+                           width, height) &&
+            createShmImage(window, 1, attribs.visual, attribs.depth,
+                           width, height))
+        {
+            window->x11.pixels.count = 2;
+        }
+        else
+            destroyPixelBuffers(window);
+    }
+
+    if (!window->x11.pixels.count)
+    {
+        XImage* image = XCreateImage(_glfw.x11.display,
+                                     attribs.visual, attribs.depth,
+                                     ZPixmap, 0, NULL,
+                                     width, height, 32, 0);
+        if (!image)
+        {
+            _glfwInputError(GLFW_PLATFORM_ERROR,
+                            "X11: Failed to create pixel buffer image");
+            return GLFW_FALSE;
+        }
+
+        image->data = calloc(image->height, image->bytes_per_line);
+        if (!image->data)
+        {
+            XDestroyImage(image);
+            _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+            return GLFW_FALSE;
+        }
+
+        window->x11.pixels.images[0] = image;
+        window->x11.pixels.count = 1;
+    }
+
+    if (window->x11.pixels.images[0]->bits_per_pixel != 32)
+    {
+        destroyPixelBuffers(window);
+        _glfwInputError(GLFW_FORMAT_UNAVAILABLE,
+                        "X11: Window visual does not use 32-bit pixels");
+        return GLFW_FALSE;
+    }
+
+    window->x11.pixels.gc = XCreateGC(_glfw.x11.display, window->x11.handle,
+                                      0, NULL);
+    return GLFW_TRUE;
+}
+
+// Makes the back pixel buffer safe to draw to and copies into it the areas
+// changed in the most recently presented frame
+//
+static void prepareBackPixelBuffer(_GLFWwindow* window)
+{
+    int y;
+    const XImage* front;
+    XImage* back;
+
+    if (window->x11.pixels.count < 2)
+        return;
+
+    waitForPixelBuffer(window, window->x11.pixels.back);
+
+    front = window->x11.pixels.images[window->x11.pixels.back ^ 1];
+    back = window->x11.pixels.images[window->x11.pixels.back];
+
+    for (y = window->x11.pixels.damageY;
+         y < window->x11.pixels.damageY + window->x11.pixels.damageHeight;
+         y++)
+    {
+        const size_t offset = y * back->bytes_per_line +
+                              window->x11.pixels.damageX * 4;
+
+        memcpy(back->data + offset, front->data + offset,
+               window->x11.pixels.damageWidth * 4);
+    }
+
+    window->x11.pixels.damageHeight = 0;
+}
+
+// Reports the timing of a frame shown or skipped by the server
+//
+static void handlePresentComplete(const XPresentCompleteNotifyEvent* event)
+{
+    uint64_t time;
+    int flags = 0;
+    _GLFWwindow* window = findWindow(event->window);
+
+    // Completions of MSC notifications do not correspond to frames
+    if (!window || event->kind != PresentCompleteKindPixmap)
+        return;
+
+    if (event->mode == PresentCompleteModeSkip)
+        flags |= GLFW_FRAME_SKIPPED;
+    else
+    {
+        const uint64_t interval =
+            window->context.interval > 1 ? window->context.interval : 1;
+
+        if (window->x11.lastMsc && event->msc > window->x11.lastMsc + interval)
+            flags |= GLFW_FRAME_MISSED_VBLANK;
+
+        window->x11.lastMsc = event->msc;
+    }
+
+    // NOTE: UST is in microseconds of the monotonic clock, which the timer also
+    //       uses if it is available
+    if (_glfw.timer.posix.monotonic)
+        time = event->ust * (_glfw.timer.posix.frequency / 1000000);
+    else
+        time = _glfwPlatformGetTimerValue();
 
-    _glfw.x11.saver.count--;
+    _glfwInputFramePresented(window, time, event->msc, flags);
+}
 
-    if (_glfw.x11.saver.count == 0)
+// Retrieves the server timestamp of the specified event, if it has one
+//
+static GLFWbool getEventTime(const XEvent* event, Time* time)
+{
+    switch (event->type)
     {
-        // Restore old screen saver settings
-        XSetScreenSaver(_glfw.x11.display,
-                        _glfw.x11.saver.timeout,
-                        _glfw.x11.saver.interval,
-                        _glfw.x11.saver.blanking,
-                        _glfw.x11.saver.exposure);
+        case KeyPress:
+        case KeyRelease:
+            *time = event->xkey.time;
+            return GLFW_TRUE;
+        case ButtonPress:
+        case ButtonRelease:
+            *time = event->xbutton.time;
+            return GLFW_TRUE;
+        case MotionNotify:
+            *time = event->xmotion.time;
+            return GLFW_TRUE;
+        case EnterNotify:
+        case LeaveNotify:
+            *time = event->xcrossing.time;
+            return GLFW_TRUE;
+        case PropertyNotify:
+            *time = event->xproperty.time;
+            return GLFW_TRUE;
+        case SelectionNotify:
+            *time = event->xselection.time;
+            return GLFW_TRUE;
     }
+
+    return GLFW_FALSE;
 }
 
 // Process the specified X event
@@ -1168,11 +2668,19 @@ static void processEvent(XEvent *event)
 {
     int keycode = 0;
     Bool filtered = False;
+    Time time;
 
     // HACK: Save scancode as some IMs clear the field in XFilterEvent
     if (event->type == KeyPress || event->type == KeyRelease)
         keycode = event->xkey.keycode;
 
+    if (_glfw.x11.eventThread.time)
+        _glfwInputEventTime(_glfw.x11.eventThread.time);
+    else if (getEventTime(event, &time))
+        _glfwInputEventTime(_glfwTranslateEventTime((uint32_t) time));
+    else
+        _glfwInputEventTime(0);
+
     if (_glfw.x11.im)
         filtered = XFilterEvent(event, None);
 
@@ -1181,7 +2689,20 @@ static void processEvent(XEvent *event)
         if (event->type == _glfw.x11.randr.eventBase + RRNotify)
         {
             XRRUpdateConfiguration(event);
-            _glfwPollMonitorsX11();
+
+            if (((XRRNotifyEvent*) event)->subtype == RRNotify_OutputChange)
+                _glfwUpdateOutputX11((XRROutputChangeNotifyEvent*) event);
+            else
+                _glfwPollMonitorsX11();
+
+            return;
+        }
+
+        if (event->type == _glfw.x11.randr.eventBase + RRScreenChangeNotify)
+        {
+            // The configuration time of the cached resources is now stale
+            XRRUpdateConfiguration(event);
+            _glfwInvalidateScreenResourcesX11();
             return;
         }
     }
@@ -1202,14 +2723,24 @@ static void processEvent(XEvent *event)
 
     if (event->type == GenericEvent)
     {
-        if (_glfw.x11.xi.available)
+        // NOTE: The event data, if any, was claimed when the event was removed
+        //       from the Xlib queue and is freed here after being processed
+        if (!event->xcookie.data)
+            return;
+
+        if (_glfw.x11.present.available &&
+            event->xcookie.extension == _glfw.x11.present.majorOpcode)
+        {
+            if (event->xcookie.evtype == PresentCompleteNotify)
+                handlePresentComplete(event->xcookie.data);
+        }
+        else if (_glfw.x11.xi.available)
         {
             _GLFWwindow* window = _glfw.x11.disabledCursorWindow;
 
             if (window &&
                 window->rawMouseMotion &&
                 event->xcookie.extension == _glfw.x11.xi.majorOpcode &&
-                XGetEventData(_glfw.x11.display, &event->xcookie) &&
                 event->xcookie.evtype == XI_RawMotion)
             {
                 XIRawEvent* re = event->xcookie.data;
@@ -1219,6 +2750,8 @@ static void processEvent(XEvent *event)
                     double xpos = window->virtualCursorPosX;
                     double ypos = window->virtualCursorPosY;
 
+                    _glfwInputEventTime(_glfwTranslateEventTime((uint32_t) re->time));
+
                     if (XIMaskIsSet(re->valuators.mask, 0))
                     {
                         xpos += *values;
@@ -1231,13 +2764,21 @@ static void processEvent(XEvent *event)
                     _glfwInputCursorPos(window, xpos, ypos);
                 }
             }
-
-            XFreeEventData(_glfw.x11.display, &event->xcookie);
         }
 
+        XFreeEventData(_glfw.x11.display, &event->xcookie);
         return;
     }
 
+    if (event->type == PropertyNotify && handleTransferProperty(&event->xproperty))
+        return;
+
+    if (event->type == DestroyNotify)
+        handleTransferDestroy(&event->xdestroywindow);
+
+    if (handleClipboardRequestEvent(event))
+        return;
+
     if (event->type == SelectionClear)
     {
         handleSelectionClear(event);
@@ -1249,16 +2790,22 @@ static void processEvent(XEvent *event)
         return;
     }
 
-    _GLFWwindow* window = NULL;
-    if (XFindContext(_glfw.x11.display,
-                     event->xany.window,
-                     _glfw.x11.context,
-                     (XPointer*) &window) != 0)
+    _GLFWwindow* window = findWindow(event->xany.window);
+    if (!window)
     {
         // This is an event for a window that has already been destroyed
         return;
     }
 
+    if (_glfw.x11.xshm.available)
+    {
+        if (event->type == _glfw.x11.xshm.eventBase + ShmCompletion)
+        {
+            handleShmCompletion(window, (XShmCompletionEvent*) event);
+            return;
+        }
+    }
+
     switch (event->type)
     {
         case ReparentNotify:
@@ -1374,15 +2921,20 @@ static void processEvent(XEvent *event)
 
             if (!_glfw.x11.xkb.detectable)
             {
+                XEvent next;
+                GLFWbool queued;
+
                 // HACK: Key repeat events will arrive as KeyRelease/KeyPress
                 //       pairs with similar or identical time stamps
                 //       The key repeat logic in _glfwInputKey expects only key
                 //       presses to repeat, so detect and discard release events
-                if (XEventsQueued(_glfw.x11.display, QueuedAfterReading))
-                {
-                    XEvent next;
-                    XPeekEvent(_glfw.x11.display, &next);
+                if (_glfw.x11.eventThread.running)
+                    queued = peekQueuedEvent(&next);
+                else
+                    queued = peekBatchedEvent(&next);
 
+                if (queued)
+                {
                     if (next.type == KeyPress &&
                         next.xkey.window == event->xkey.window &&
                         next.xkey.keycode == keycode)
@@ -1491,6 +3043,11 @@ static void processEvent(XEvent *event)
             if (window->cursorMode == GLFW_CURSOR_HIDDEN)
                 updateCursorImage(window);
 
+            // Crossings caused by a grab starting do not move the cursor,
+            // while those caused by a grab ending report where it now is
+            if (event->xcrossing.mode != NotifyGrab)
+                window->x11.hovered = GLFW_TRUE;
+
             _glfwInputCursorEnter(window, GLFW_TRUE);
             _glfwInputCursorPos(window, x, y);
 
@@ -1501,7 +3058,21 @@ static void processEvent(XEvent *event)
 
         case LeaveNotify:
         {
+            // Crossings caused by a grab starting do not move the cursor,
+            // while those caused by a grab ending report where it now is
+            if (event->xcrossing.mode != NotifyGrab)
+                window->x11.hovered = GLFW_FALSE;
+
             _glfwInputCursorEnter(window, GLFW_FALSE);
+
+            // Motion is no longer reported, so keep the exit point as the
+            // cursor position
+            if (window->cursorMode != GLFW_CURSOR_DISABLED)
+            {
+                window->x11.lastCursorPosX = event->xcrossing.x;
+                window->x11.lastCursorPosY = event->xcrossing.y;
+            }
+
             return;
         }
 
@@ -1580,6 +3151,14 @@ static void processEvent(XEvent *event)
 
             if (xpos != window->x11.xpos || ypos != window->x11.ypos)
             {
+                // A window moving under the cursor does not move it on
+                // screen, only relative to the content area
+                if (window->cursorMode != GLFW_CURSOR_DISABLED)
+                {
+                    window->x11.lastCursorPosX -= xpos - window->x11.xpos;
+                    window->x11.lastCursorPosY -= ypos - window->x11.ypos;
+                }
+
                 _glfwInputWindowPos(window, xpos, ypos);
                 window->x11.xpos = xpos;
                 window->x11.ypos = ypos;
@@ -1806,6 +3385,7 @@ static void processEvent(XEvent *event)
             if (window->x11.ic)
                 XSetICFocus(window->x11.ic);
 
+            window->x11.focused = GLFW_TRUE;
             _glfwInputWindowFocus(window, GLFW_TRUE);
             return;
         }
@@ -1829,6 +3409,7 @@ static void processEvent(XEvent *event)
             if (window->monitor && window->autoIconify)
                 _glfwPlatformIconifyWindow(window);
 
+            window->x11.focused = GLFW_FALSE;
             _glfwInputWindowFocus(window, GLFW_FALSE);
             return;
         }
@@ -1867,7 +3448,7 @@ static void processEvent(XEvent *event)
             }
             else if (event->xproperty.atom == _glfw.x11.NET_WM_STATE)
             {
-                const GLFWbool maximized = _glfwPlatformWindowMaximized(window);
+                const GLFWbool maximized = queryWindowMaximized(window);
                 if (window->x11.maximized != maximized)
                 {
                     window->x11.maximized = maximized;
@@ -1883,6 +3464,213 @@ static void processEvent(XEvent *event)
     }
 }
 
+// Returns the FNV-1a hash of the sizes and pixels of the specified images
+//
+static uint64_t hashImages(const GLFWimage* images, int count)
+{
+    uint64_t hash = 14695981039346656037u;
+
+    for (int i = 0;  i < count;  i++)
+    {
+        const unsigned char* pixels = images[i].pixels;
+        const size_t size = (size_t) images[i].width * images[i].height * 4;
+
+        hash = (hash ^ (uint32_t) images[i].width) * 1099511628211u;
+        hash = (hash ^ (uint32_t) images[i].height) * 1099511628211u;
+
+        for (size_t j = 0;  j < size;  j++)
+            hash = (hash ^ pixels[j]) * 1099511628211u;
+    }
+
+    return hash;
+}
+
+// Returns whether the key holds exactly the specified images
+//
+static GLFWbool matchImageKey(const _GLFWimagekeyX11* key, uint64_t hash,
+                              const GLFWimage* images, int count)
+{
+    const unsigned char* data = key->data;
+    const unsigned char* end = key->data + key->size;
+
+    if (!key->data || key->hash != hash)
+        return GLFW_FALSE;
+
+    for (int i = 0;  i < count;  i++)
+    {
+        const size_t size = (size_t) images[i].width * images[i].height * 4;
+
+        if ((size_t) (end - data) < sizeof(int) * 2 + size ||
+            memcmp(data, &images[i].width, sizeof(int)) != 0 ||
+            memcmp(data + sizeof(int), &images[i].height, sizeof(int)) != 0 ||
+            memcmp(data + sizeof(int) * 2, images[i].pixels, size) != 0)
+        {
+            return GLFW_FALSE;
+        }
+
+        data += sizeof(int) * 2 + size;
+    }
+
+    return data == end;
+}
+
+// Stores a copy of the specified images in the key
+//
+static GLFWbool setImageKey(_GLFWimagekeyX11* key, uint64_t hash,
+                            const GLFWimage* images, int count)
+{
+    size_t size = 0;
+    unsigned char* data;
+
+    for (int i = 0;  i < count;  i++)
+        size += sizeof(int) * 2 + (size_t) images[i].width * images[i].height * 4;
+
+    data = malloc(size);
+    if (!data)
+        return GLFW_FALSE;
+
+    free(key->data);
+    key->hash = hash;
+    key->data = data;
+    key->size = size;
+
+    for (int i = 0;  i < count;  i++)
+    {
+        const size_t pixelSize = (size_t) images[i].width * images[i].height * 4;
+
+        memcpy(data, &images[i].width, sizeof(int));
+        memcpy(data + sizeof(int), &images[i].height, sizeof(int));
+        memcpy(data + sizeof(int) * 2, images[i].pixels, pixelSize);
+        data += sizeof(int) * 2 + pixelSize;
+    }
+
+    return GLFW_TRUE;
+}
+
+// Returns the cached _NET_WM_ICON data for the specified images, converting
+// them and replacing the least recently used entry if they are not cached
+//
+static _GLFWiconcacheX11* acquireIcon(const GLFWimage* images, int count)
+{
+    int i, j, longCount = 0;
+    _GLFWiconcacheX11* entry = NULL;
+    const uint64_t hash = hashImages(images, count);
+
+    for (i = 0;  i < _GLFW_X11_IMAGE_CACHE_SIZE;  i++)
+    {
+        _GLFWiconcacheX11* candidate = _glfw.x11.iconCache.entries + i;
+
+        if (matchImageKey(&candidate->key, hash, images, count))
+        {
+            candidate->lastUse = ++_glfw.x11.iconCache.serial;
+            return candidate;
+        }
+
+        if (!entry || candidate->lastUse < entry->lastUse)
+            entry = candidate;
+    }
+
+    for (i = 0;  i < count;  i++)
+        longCount += 2 + images[i].width * images[i].height;
+
+    unsigned long* icon = calloc(longCount, sizeof(unsigned long));
+    if (!icon)
+        return NULL;
+
+    if (!setImageKey(&entry->key, hash, images, count))
+    {
+        free(icon);
+        return NULL;
+    }
+
+    unsigned long* target = icon;
+
+    for (i = 0;  i < count;  i++)
+    {
+        *target++ = images[i].width;
+        *target++ = images[i].height;
+
+        for (j = 0;  j < images[i].width * images[i].height;  j++)
+        {
+            *target++ = (((unsigned long) images[i].pixels[j * 4 + 0]) << 16) |
+                        (((unsigned long) images[i].pixels[j * 4 + 1]) <<  8) |
+                        (((unsigned long) images[i].pixels[j * 4 + 2]) <<  0) |
+                        (((unsigned long) images[i].pixels[j * 4 + 3]) << 24);
+        }
+    }
+
+    free(entry->data);
+    entry->data = icon;
+    entry->longCount = longCount;
+    entry->id = entry->lastUse = ++_glfw.x11.iconCache.serial;
+    return entry;
+}
+
+// Returns a cursor for the specified image and hotspot, reusing a cached
+// cursor with the same contents if there is one
+//
+static Cursor acquireCursor(const GLFWimage* image, int xhot, int yhot)
+{
+    Cursor handle;
+    _GLFWcursorcacheX11* entry = NULL;
+    const uint64_t hash = hashImages(image, 1);
+
+    for (int i = 0;  i < _GLFW_X11_IMAGE_CACHE_SIZE;  i++)
+    {
+        _GLFWcursorcacheX11* candidate = _glfw.x11.cursorCache.entries + i;
+
+        if (candidate->xhot == xhot && candidate->yhot == yhot &&
+            matchImageKey(&candidate->key, hash, image, 1))
+        {
+            candidate->refs++;
+            candidate->lastUse = ++_glfw.x11.cursorCache.serial;
+            return candidate->handle;
+        }
+
+        // Only cursors no longer in use can be evicted
+        if (candidate->refs == 0 &&
+            (!entry || candidate->lastUse < entry->lastUse))
+        {
+            entry = candidate;
+        }
+    }
+
+    handle = _glfwCreateCursorX11(image, xhot, yhot);
+    if (!handle || !entry)
+        return handle;
+
+    if (!setImageKey(&entry->key, hash, image, 1))
+        return handle;
+
+    if (entry->handle)
+        XFreeCursor(_glfw.x11.display, entry->handle);
+
+    entry->xhot = xhot;
+    entry->yhot = yhot;
+    entry->handle = handle;
+    entry->refs = 1;
+    entry->lastUse = ++_glfw.x11.cursorCache.serial;
+    return handle;
+}
+
+// Releases a cursor returned by acquireCursor, keeping cached cursors alive
+// until they are evicted
+//
+static void releaseCursor(Cursor handle)
+{
+    for (int i = 0;  i < _GLFW_X11_IMAGE_CACHE_SIZE;  i++)
+    {
+        _GLFWcursorcacheX11* entry = _glfw.x11.cursorCache.entries + i;
+        if (entry->handle == handle && entry->refs > 0)
+        {
+            entry->refs--;
+            return;
+        }
+    }
+
+    XFreeCursor(_glfw.x11.display, handle);
+}
+
 
 //////////////////////////////////////////////////////////////////////////
 //////                       GLFW internal API                      //////
@@ -1918,7 +3706,7 @@ unsigned long _glfwGetWindowPropertyX11(Window window,
 
 GLFWbool _glfwIsVisualTransparentX11(Visual* visual)
 {
-    if (!_glfw.x11.xrender.available)
+    if (!_glfwLoadXrenderX11())
         return GLFW_FALSE;
 
     XRenderPictFormat* pf = XRenderFindVisualFormat(_glfw.x11.display, visual);
@@ -1952,6 +3740,14 @@ void _glfwPushSelectionToManagerX11(void)
                     handleSelectionClear(&event);
                     break;
 
+                case PropertyNotify:
+                    handleTransferProperty(&event.xproperty);
+                    break;
+
+                case DestroyNotify:
+                    handleTransferDestroy(&event.xdestroywindow);
+                    break;
+
                 case SelectionNotify:
                 {
                     if (event.xselection.target == _glfw.x11.SAVE_TARGETS)
@@ -1973,6 +3769,49 @@ void _glfwPushSelectionToManagerX11(void)
     }
 }
 
+// Starts the thread reading input events from the X connection
+//
+GLFWbool _glfwStartEventThreadX11(void)
+{
+    if (pthread_mutex_init(&_glfw.x11.eventThread.lock, NULL) != 0)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "X11: Failed to create event thread mutex");
+        return GLFW_FALSE;
+    }
+
+    if (pthread_create(&_glfw.x11.eventThread.thread, NULL,
+                       eventThreadMain, NULL) != 0)
+    {
+        pthread_mutex_destroy(&_glfw.x11.eventThread.lock);
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "X11: Failed to create event thread");
+        return GLFW_FALSE;
+    }
+
+    _glfw.x11.eventThread.running = GLFW_TRUE;
+    return GLFW_TRUE;
+}
+
+// Stops the event thread and discards any unprocessed input events
+//
+void _glfwStopEventThreadX11(void)
+{
+    writeToPipe(_glfw.x11.eventThread.stopPipe[1]);
+    pthread_join(_glfw.x11.eventThread.thread, NULL);
+    pthread_mutex_destroy(&_glfw.x11.eventThread.lock);
+
+    _glfw.x11.eventThread.running = GLFW_FALSE;
+
+    free(_glfw.x11.eventThread.pending);
+    free(_glfw.x11.eventThread.events);
+    _glfw.x11.eventThread.pending = NULL;
+    _glfw.x11.eventThread.events = NULL;
+    _glfw.x11.eventThread.pendingCount = _glfw.x11.eventThread.pendingSize = 0;
+    _glfw.x11.eventThread.count = _glfw.x11.eventThread.size = 0;
+    _glfw.x11.eventThread.next = 0;
+}
+
 
 //////////////////////////////////////////////////////////////////////////
 //////                       GLFW platform API                      //////
@@ -2065,9 +3904,11 @@ void _glfwPlatformDestroyWindow(_GLFWwindow* window)
     if (window->context.destroy)
         window->context.destroy(window);
 
+    destroyPixelBuffers(window);
+
     if (window->x11.handle)
     {
-        XDeleteContext(_glfw.x11.display, window->x11.handle, _glfw.x11.context);
+        removeWindowFromTable(window);
         XUnmapWindow(_glfw.x11.display, window->x11.handle);
         XDestroyWindow(_glfw.x11.display, window->x11.handle);
         window->x11.handle = (Window) 0;
@@ -2118,29 +3959,19 @@ void _glfwPlatformSetWindowIcon(_GLFWwindow* window,
 {
     if (count)
     {
-        int i, j, longCount = 0;
-
-        for (i = 0;  i < count;  i++)
-            longCount += 2 + images[i].width * images[i].height;
-
-        unsigned long* icon = calloc(longCount, sizeof(unsigned long));
-        unsigned long* target = icon;
-
-        for (i = 0;  i < count;  i++)
+        const _GLFWiconcacheX11* icon = acquireIcon(images, count);
+        if (!icon)
         {
-            *target++ = images[i].width;
-            *target++ = images[i].height;
-
-            for (j = 0;  j < images[i].width * images[i].height;  j++)
-            {
-                *target++ = (((unsigned long) images[i].pixels[j * 4 + 0]) << 16) |
-                            (((unsigned long) images[i].pixels[j * 4 + 1]) <<  8) |
-                            (((unsigned long) images[i].pixels[j * 4 + 2]) <<  0) |
-                            (((unsigned long) images[i].pixels[j * 4 + 3]) << 24);
-            }
+            _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+            return;
         }
 
-        // NOTE: XChangeProperty expects 32-bit values like the image data above to be
+        // Setting the icon the window already has would only make the
+        // server and window manager process the same data again
+        if (icon->id == window->x11.iconId)
+            return;
+
+        // NOTE: XChangeProperty expects 32-bit values like the icon data to be
         //       placed in the 32 least significant bits of individual longs.  This is
         //       true even if long is 64-bit and a WM protocol calls for "packed" data.
         //       This is because of a historical mistake that then became part of the Xlib
@@ -2150,15 +3981,16 @@ void _glfwPlatformSetWindowIcon(_GLFWwindow* window,
                         _glfw.x11.NET_WM_ICON,
                         XA_CARDINAL, 32,
                         PropModeReplace,
-                        (unsigned char*) icon,
-                        longCount);
+                        (unsigned char*) icon->data,
+                        icon->longCount);
 
-        free(icon);
+        window->x11.iconId = icon->id;
     }
     else
     {
         XDeleteProperty(_glfw.x11.display, window->x11.handle,
                         _glfw.x11.NET_WM_ICON);
+        window->x11.iconId = 0;
     }
 
     XFlush(_glfw.x11.display);
@@ -2166,16 +3998,10 @@ void _glfwPlatformSetWindowIcon(_GLFWwindow* window,
 
 void _glfwPlatformGetWindowPos(_GLFWwindow* window, int* xpos, int* ypos)
 {
-    Window dummy;
-    int x, y;
-
-    XTranslateCoordinates(_glfw.x11.display, window->x11.handle, _glfw.x11.root,
-                          0, 0, &x, &y, &dummy);
-
     if (xpos)
-        *xpos = x;
+        *xpos = window->x11.xpos;
     if (ypos)
-        *ypos = y;
+        *ypos = window->x11.ypos;
 }
 
 void _glfwPlatformSetWindowPos(_GLFWwindow* window, int xpos, int ypos)
@@ -2204,13 +4030,10 @@ void _glfwPlatformSetWindowPos(_GLFWwindow* window, int xpos, int ypos)
 
 void _glfwPlatformGetWindowSize(_GLFWwindow* window, int* width, int* height)
 {
-    XWindowAttributes attribs;
-    XGetWindowAttributes(_glfw.x11.display, window->x11.handle, &attribs);
-
     if (width)
-        *width = attribs.width;
+        *width = window->x11.width;
     if (height)
-        *height = attribs.height;
+        *height = window->x11.height;
 }
 
 void _glfwPlatformSetWindowSize(_GLFWwindow* window, int width, int height)
@@ -2350,7 +4173,9 @@ void _glfwPlatformRestoreWindow(_GLFWwindow* window)
         return;
     }
 
-    if (_glfwPlatformWindowIconified(window))
+    // The state is queried as the WM may not have reported an iconification
+    // requested just before this
+    if (getWindowState(window) == IconicState)
     {
         XMapWindow(_glfw.x11.display, window->x11.handle);
         waitForVisibilityNotify(window);
@@ -2537,87 +4362,30 @@ void _glfwPlatformSetWindowMonitor(_GLFWwindow* window,
 }
 
 int _glfwPlatformWindowFocused(_GLFWwindow* window)
-{
-    Window focused;
-    int state;
-
-    XGetInputFocus(_glfw.x11.display, &focused, &state);
-    return window->x11.handle == focused;
-}
-
-int _glfwPlatformWindowIconified(_GLFWwindow* window)
-{
-    return getWindowState(window) == IconicState;
-}
-
-int _glfwPlatformWindowVisible(_GLFWwindow* window)
-{
-    XWindowAttributes wa;
-    XGetWindowAttributes(_glfw.x11.display, window->x11.handle, &wa);
-    return wa.map_state == IsViewable;
-}
-
-int _glfwPlatformWindowMaximized(_GLFWwindow* window)
-{
-    Atom* states;
-    unsigned long i;
-    GLFWbool maximized = GLFW_FALSE;
-
-    if (!_glfw.x11.NET_WM_STATE ||
-        !_glfw.x11.NET_WM_STATE_MAXIMIZED_VERT ||
-        !_glfw.x11.NET_WM_STATE_MAXIMIZED_HORZ)
-    {
-        return maximized;
-    }
-
-    const unsigned long count =
-        _glfwGetWindowPropertyX11(window->x11.handle,
-                                  _glfw.x11.NET_WM_STATE,
-                                  XA_ATOM,
-                                  (unsigned char**) &states);
-
-    for (i = 0;  i < count;  i++)
-    {
-        if (states[i] == _glfw.x11.NET_WM_STATE_MAXIMIZED_VERT ||
-            states[i] == _glfw.x11.NET_WM_STATE_MAXIMIZED_HORZ)
-        {
-            maximized = GLFW_TRUE;
-            break;
-        }
-    }
-
-    if (states)
-        XFree(states);
-
-    return maximized;
+{
+    return window->x11.focused;
 }
 
-int _glfwPlatformWindowHovered(_GLFWwindow* window)
+int _glfwPlatformWindowIconified(_GLFWwindow* window)
 {
-    Window w = _glfw.x11.root;
-    while (w)
-    {
-        Window root;
-        int rootX, rootY, childX, childY;
-        unsigned int mask;
-
-        _glfwGrabErrorHandlerX11();
-
-        const Bool result = XQueryPointer(_glfw.x11.display, w,
-                                          &root, &w, &rootX, &rootY,
-                                          &childX, &childY, &mask);
+    return window->x11.iconified;
+}
 
-        _glfwReleaseErrorHandlerX11();
+int _glfwPlatformWindowVisible(_GLFWwindow* window)
+{
+    XWindowAttributes wa;
+    XGetWindowAttributes(_glfw.x11.display, window->x11.handle, &wa);
+    return wa.map_state == IsViewable;
+}
 
-        if (_glfw.x11.errorCode == BadWindow)
-            w = _glfw.x11.root;
-        else if (!result)
-            return GLFW_FALSE;
-        else if (w == window->x11.handle)
-            return GLFW_TRUE;
-    }
+int _glfwPlatformWindowMaximized(_GLFWwindow* window)
+{
+    return window->x11.maximized;
+}
 
-    return GLFW_FALSE;
+int _glfwPlatformWindowHovered(_GLFWwindow* window)
+{
+    return window->x11.hovered;
 }
 
 int _glfwPlatformFramebufferTransparent(_GLFWwindow* window)
@@ -2758,9 +4526,147 @@ void _glfwPlatformSetWindowOpacity(_GLFWwindow* window, float opacity)
                     PropModeReplace, (unsigned char*) &value, 1);
 }
 
+unsigned char* _glfwPlatformGetWindowPixelBuffer(_GLFWwindow* window,
+                                                 int* width, int* height,
+                                                 int* stride)
+{
+    const XImage* image = window->x11.pixels.images[0];
+
+    if (!image ||
+        image->width != window->x11.width ||
+        image->height != window->x11.height)
+    {
+        destroyPixelBuffers(window);
+
+        if (!createPixelBuffers(window, window->x11.width, window->x11.height))
+            return NULL;
+    }
+    else
+        prepareBackPixelBuffer(window);
+
+    image = window->x11.pixels.images[window->x11.pixels.back];
+
+    if (width)
+        *width = image->width;
+    if (height)
+        *height = image->height;
+    if (stride)
+        *stride = image->bytes_per_line;
+
+    return (unsigned char*) image->data;
+}
+
+void _glfwPlatformPresentPixelBuffer(_GLFWwindow* window,
+                                     const int* rects, int count)
+{
+    int i, x0, y0, x1, y1;
+    XImage* image;
+    const int back = window->x11.pixels.back;
+
+    if (!window->x11.pixels.count)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "X11: Window has no pixel buffer to present");
+        return;
+    }
+
+    // The back buffer may not have been retrieved since the last present
+    prepareBackPixelBuffer(window);
+
+    image = window->x11.pixels.images[back];
+
+    if (count)
+    {
+        int clipCount = 0;
+        XRectangle* clips = calloc(count, sizeof(XRectangle));
+        if (!clips)
+        {
+            _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+            return;
+        }
+
+        x0 = image->width;
+        y0 = image->height;
+        x1 = y1 = 0;
+
+        for (i = 0;  i < count;  i++)
+        {
+            const int64_t x = rects[i * 4 + 0];
+            const int64_t y = rects[i * 4 + 1];
+            const int64_t left = x > 0 ? x : 0;
+            const int64_t top = y > 0 ? y : 0;
+            int64_t right = x + rects[i * 4 + 2];
+            int64_t bottom = y + rects[i * 4 + 3];
+
+            if (right > image->width)
+                right = image->width;
+            if (bottom > image->height)
+                bottom = image->height;
+
+            if (left >= right || top >= bottom)
+                continue;
+
+            clips[clipCount].x = (short) left;
+            clips[clipCount].y = (short) top;
+            clips[clipCount].width = (unsigned short) (right - left);
+            clips[clipCount].height = (unsigned short) (bottom - top);
+            clipCount++;
+
+            if (x0 > left)
+                x0 = (int) left;
+            if (y0 > top)
+                y0 = (int) top;
+            if (x1 < right)
+                x1 = (int) right;
+            if (y1 < bottom)
+                y1 = (int) bottom;
+        }
+
+        if (clipCount)
+        {
+            XSetClipRectangles(_glfw.x11.display, window->x11.pixels.gc,
+                               0, 0, clips, clipCount, Unsorted);
+        }
+
+        free(clips);
+
+        if (!clipCount)
+            return;
+    }
+    else
+    {
+        x0 = y0 = 0;
+        x1 = image->width;
+        y1 = image->height;
+        XSetClipMask(_glfw.x11.display, window->x11.pixels.gc, None);
+    }
+
+    if (window->x11.pixels.count == 2)
+    {
+        XShmPutImage(_glfw.x11.display, window->x11.handle,
+                     window->x11.pixels.gc, image,
+                     x0, y0, x0, y0, x1 - x0, y1 - y0, True);
+
+        window->x11.pixels.busy[back] = GLFW_TRUE;
+        window->x11.pixels.damageX = x0;
+        window->x11.pixels.damageY = y0;
+        window->x11.pixels.damageWidth = x1 - x0;
+        window->x11.pixels.damageHeight = y1 - y0;
+        window->x11.pixels.back = back ^ 1;
+    }
+    else
+    {
+        XPutImage(_glfw.x11.display, window->x11.handle,
+                  window->x11.pixels.gc, image,
+                  x0, y0, x0, y0, x1 - x0, y1 - y0);
+    }
+
+    XFlush(_glfw.x11.display);
+}
+
 void _glfwPlatformSetRawMouseMotion(_GLFWwindow *window, GLFWbool enabled)
 {
-    if (!_glfw.x11.xi.available)
+    if (!_glfwLoadXiX11())
         return;
 
     if (_glfw.x11.disabledCursorWindow != window)
@@ -2774,25 +4680,42 @@ void _glfwPlatformSetRawMouseMotion(_GLFWwindow *window, GLFWbool enabled)
 
 GLFWbool _glfwPlatformRawMouseMotionSupported(void)
 {
-    return _glfw.x11.xi.available;
+    return _glfwLoadXiX11();
 }
 
 void _glfwPlatformPollEvents(void)
 {
     _GLFWwindow* window;
 
+    drainPipe(_glfw.x11.emptyEventPipe[0]);
+
 #if defined(__linux__)
     _glfwDetectJoystickConnectionLinux();
 #endif
     XPending(_glfw.x11.display);
 
-    while (XQLength(_glfw.x11.display))
+    if (_glfw.x11.eventThread.running)
+    {
+        XEvent event;
+
+        drainPipe(_glfw.x11.eventThread.wakePipe[0]);
+
+        while (nextQueuedEvent(&event))
+            processEvent(&event);
+
+        _glfw.x11.eventThread.time = 0;
+    }
+    else
     {
         XEvent event;
-        XNextEvent(_glfw.x11.display, &event);
-        processEvent(&event);
+
+        while (nextBatchedEvent(&event))
+            processEvent(&event);
     }
 
+    completeLocalClipboardRequests();
+    dispatchWaitFds();
+
     window = _glfw.x11.disabledCursorWindow;
     if (window)
     {
@@ -2813,17 +4736,27 @@ void _glfwPlatformPollEvents(void)
 
 void _glfwPlatformWaitEvents(void)
 {
-    while (!XPending(_glfw.x11.display))
-        waitForEvent(NULL);
+    // NOTE: The X connection may become readable without a whole event having
+    //       arrived, or with the awaited reply read by another thread
+    while (!XPending(_glfw.x11.display) && !hasInputEvents())
+    {
+        if (waitForAnyEvent(NULL))
+            break;
+    }
 
     _glfwPlatformPollEvents();
 }
 
 void _glfwPlatformWaitEventsTimeout(double timeout)
 {
-    while (!XPending(_glfw.x11.display))
+    _glfwPlatformWaitEventsUntil(_glfwGetDeadlinePOSIX(timeout));
+}
+
+void _glfwPlatformWaitEventsUntil(uint64_t deadline)
+{
+    while (!XPending(_glfw.x11.display) && !hasInputEvents())
     {
-        if (!waitForEvent(&timeout))
+        if (waitForAnyEvent(&deadline))
             break;
     }
 
@@ -2832,16 +4765,55 @@ void _glfwPlatformWaitEventsTimeout(double timeout)
 
 void _glfwPlatformPostEmptyEvent(void)
 {
-    XEvent event = { ClientMessage };
-    event.xclient.window = _glfw.x11.helperWindowHandle;
-    event.xclient.format = 32; // Data is 32-bit longs
-    event.xclient.message_type = _glfw.x11.NULL_;
+    writeToPipe(_glfw.x11.emptyEventPipe[1]);
+}
 
-    XSendEvent(_glfw.x11.display, _glfw.x11.helperWindowHandle, False, 0, &event);
-    XFlush(_glfw.x11.display);
+GLFWbool _glfwPlatformAddWaitFd(int fd)
+{
+    struct pollfd* pollfds = realloc(_glfw.x11.pollfds,
+                                     (_glfw.x11.pollfdCount + 1) *
+                                     sizeof(struct pollfd));
+    if (!pollfds)
+    {
+        _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+        return GLFW_FALSE;
+    }
+
+    pollfds[_glfw.x11.pollfdCount].fd = fd;
+    pollfds[_glfw.x11.pollfdCount].events = POLLIN;
+    pollfds[_glfw.x11.pollfdCount].revents = 0;
+
+    _glfw.x11.pollfds = pollfds;
+    _glfw.x11.pollfdCount++;
+    return GLFW_TRUE;
+}
+
+void _glfwPlatformRemoveWaitFd(int fd)
+{
+    int i;
+
+    for (i = _GLFW_X11_POLL_COUNT;  i < _glfw.x11.pollfdCount;  i++)
+    {
+        if (_glfw.x11.pollfds[i].fd == fd)
+        {
+            _glfw.x11.pollfdCount--;
+            memmove(_glfw.x11.pollfds + i,
+                    _glfw.x11.pollfds + i + 1,
+                    (_glfw.x11.pollfdCount - i) * sizeof(struct pollfd));
+            return;
+        }
+    }
 }
 
 void _glfwPlatformGetCursorPos(_GLFWwindow* window, double* xpos, double* ypos)
+{
+    if (xpos)
+        *xpos = window->x11.lastCursorPosX;
+    if (ypos)
+        *ypos = window->x11.lastCursorPosY;
+}
+
+void _glfwPlatformQueryCursorPos(_GLFWwindow* window, double* xpos, double* ypos)
 {
     Window root, child;
     int rootX, rootY, childX, childY;
@@ -2864,6 +4836,16 @@ void _glfwPlatformSetCursorPos(_GLFWwindow* window, double x, double y)
     window->x11.warpCursorPosX = (int) x;
     window->x11.warpCursorPosY = (int) y;
 
+    // NOTE: The position returned by glfwGetCursorPos is updated right away
+    //       instead of when the resulting motion event is processed, except
+    //       when re-centering a disabled cursor, as its motion deltas are
+    //       relative to the last position reported by the server
+    if (_glfw.x11.disabledCursorWindow != window)
+    {
+        window->x11.lastCursorPosX = (int) x;
+        window->x11.lastCursorPosY = (int) y;
+    }
+
     XWarpPointer(_glfw.x11.display, None, window->x11.handle,
                  0,0,0,0, (int) x, (int) y);
     XFlush(_glfw.x11.display);
@@ -2923,7 +4905,7 @@ int _glfwPlatformCreateCursor(_GLFWcursor* cursor,
                               const GLFWimage* image,
                               int xhot, int yhot)
 {
-    cursor->x11.handle = _glfwCreateCursorX11(image, xhot, yhot);
+    cursor->x11.handle = acquireCursor(image, xhot, yhot);
     if (!cursor->x11.handle)
         return GLFW_FALSE;
 
@@ -2963,7 +4945,7 @@ int _glfwPlatformCreateStandardCursor(_GLFWcursor* cursor, int shape)
 void _glfwPlatformDestroyCursor(_GLFWcursor* cursor)
 {
     if (cursor->x11.handle)
-        XFreeCursor(_glfw.x11.display, cursor->x11.handle);
+        releaseCursor(cursor->x11.handle);
 }
 
 void _glfwPlatformSetCursor(_GLFWwindow* window, _GLFWcursor* cursor)
@@ -2978,6 +4960,8 @@ void _glfwPlatformSetCursor(_GLFWwindow* window, _GLFWcursor* cursor)
 void _glfwPlatformSetClipboardString(const char* string)
 {
     char* copy = _glfw_strdup(string);
+    cancelTransfers(_glfw.x11.CLIPBOARD);
+    releaseClipboardSource();
     free(_glfw.x11.clipboardString);
     _glfw.x11.clipboardString = copy;
 
@@ -2994,11 +4978,278 @@ void _glfwPlatformSetClipboardString(const char* string)
     }
 }
 
+void _glfwPlatformRequestClipboardString(GLFWclipboardstringfun callback,
+                                         void* user)
+{
+    _GLFWclipboardrequestX11* entries;
+    _GLFWclipboardrequestX11* request;
+    XSetWindowAttributes wa = { 0 };
+
+    entries = realloc(_glfw.x11.clipboardRequests.entries,
+                      sizeof(_GLFWclipboardrequestX11) *
+                      (_glfw.x11.clipboardRequests.count + 1));
+    if (!entries)
+    {
+        _glfwInputError(GLFW_OUT_OF_MEMORY, NULL);
+        return;
+    }
+
+    _glfw.x11.clipboardRequests.entries = entries;
+    request = entries + _glfw.x11.clipboardRequests.count++;
+    memset(request, 0, sizeof(_GLFWclipboardrequestX11));
+    request->target = _glfw.x11.UTF8_STRING;
+    request->callback = callback;
+    request->user = user;
+
+    if (XGetSelectionOwner(_glfw.x11.display, _glfw.x11.CLIPBOARD) ==
+        _glfw.x11.helperWindowHandle)
+    {
+        // Answer the request from our own contents instead of transferring
+        // them through the server, but still call the callback from within
+        // the event processing functions
+        if (!_glfw.x11.clipboardSource.callback)
+        {
+            if (_glfw.x11.clipboardString)
+                request->data = _glfw_strdup(_glfw.x11.clipboardString);
+        }
+        else if (isUTF8TextTarget(_glfw.x11.clipboardSource.target))
+        {
+            size_t offset = 0;
+            const size_t total = _glfw.x11.clipboardSource.size;
+
+            for (;;)
+            {
+                const size_t requested = getMaxSelectionChunk();
+                size_t count = requested;
+                const unsigned char* data =
+                    readSelectionData(_glfw.x11.CLIPBOARD, offset, total, &count);
+
+                appendClipboardRequestData(request,
+                                           data ? (const char*) data : "",
+                                           count);
+                if (count < requested)
+                    break;
+
+                offset += count;
+            }
+        }
+
+        _glfwPlatformPostEmptyEvent();
+        return;
+    }
+
+    // NOTE: Each request gets its own requestor window, so the replies to
+    //       several requests in flight cannot be confused with each other or
+    //       with those to glfwGetClipboardString
+    wa.event_mask = PropertyChangeMask;
+    request->requestor = XCreateWindow(_glfw.x11.display, _glfw.x11.root,
+                                       0, 0, 1, 1, 0, 0,
+                                       InputOnly,
+                                       DefaultVisual(_glfw.x11.display,
+                                                     _glfw.x11.screen),
+                                       CWEventMask, &wa);
+
+    XConvertSelection(_glfw.x11.display,
+                      _glfw.x11.CLIPBOARD,
+                      request->target,
+                      _glfw.x11.GLFW_SELECTION,
+                      request->requestor,
+                      CurrentTime);
+    XFlush(_glfw.x11.display);
+}
+
+void _glfwPlatformSetClipboardDataSource(const char* mime,
+                                         size_t size,
+                                         GLFWclipboardsourcefun callback,
+                                         void* user)
+{
+    const Atom target = XInternAtom(_glfw.x11.display, mime, False);
+
+    cancelTransfers(_glfw.x11.CLIPBOARD);
+    releaseClipboardSource();
+    free(_glfw.x11.clipboardString);
+    _glfw.x11.clipboardString = NULL;
+
+    _glfw.x11.clipboardSource.target = target;
+    _glfw.x11.clipboardSource.size = size;
+    _glfw.x11.clipboardSource.callback = callback;
+    _glfw.x11.clipboardSource.user = user;
+
+    XSetSelectionOwner(_glfw.x11.display,
+                       _glfw.x11.CLIPBOARD,
+                       _glfw.x11.helperWindowHandle,
+                       CurrentTime);
+
+    if (XGetSelectionOwner(_glfw.x11.display, _glfw.x11.CLIPBOARD) !=
+        _glfw.x11.helperWindowHandle)
+    {
+        _glfwInputError(GLFW_PLATFORM_ERROR,
+                        "X11: Failed to become owner of clipboard selection");
+    }
+}
+
 const char* _glfwPlatformGetClipboardString(void)
 {
     return getSelectionString(_glfw.x11.CLIPBOARD);
 }
 
+GLFWbool _glfwPlatformGetClipboardDataStream(const char* mime,
+                                             GLFWclipboarddatafun callback,
+                                             void* user)
+{
+    Window requestor;
+    XSetWindowAttributes wa = { 0 };
+    XEvent notification, dummy;
+    size_t size;
+    GLFWbool result = GLFW_FALSE;
+    const Atom target = XInternAtom(_glfw.x11.display, mime, False);
+
+    if (XGetSelectionOwner(_glfw.x11.display, _glfw.x11.CLIPBOARD) ==
+        _glfw.x11.helperWindowHandle)
+    {
+        const Atom source = _glfw.x11.clipboardSource.target;
+
+        if (_glfw.x11.clipboardSource.callback &&
+            (target == source ||
+             (isUTF8TextTarget(target) && isUTF8TextTarget(source))))
+        {
+            size_t offset = 0;
+            const size_t total = _glfw.x11.clipboardSource.size;
+
+            // Hand our own data straight to the callback, one part at a time
+            for (;;)
+            {
+                const size_t requested = getMaxSelectionChunk();
+                size_t count = requested;
+                const unsigned char* data =
+                    readSelectionData(_glfw.x11.CLIPBOARD, offset, total, &count);
+
+                if (count && !callback(data, count, user))
+                    return GLFW_FALSE;
+                if (count < requested)
+                    return GLFW_TRUE;
+
+                offset += count;
+            }
+        }
+
+        if (!isUTF8TextTarget(target) || !_glfw.x11.clipboardString)
+        {
+            _glfwInputError(GLFW_FORMAT_UNAVAILABLE,
+                            "X11: Failed to convert selection to %s", mime);
+            return GLFW_FALSE;
+        }
+
+        return callback(_glfw.x11.clipboardString,
+                        strlen(_glfw.x11.clipboardString),
+                        user) != GLFW_FALSE;
+    }
+
+    // NOTE: Each transfer gets its own requestor window, so a cancelled
+    //       transfer can be abandoned by destroying it, which makes the owner
+    //       give up instead of writing further chunks to a later transfer
+    wa.event_mask = PropertyChangeMask;
+    requestor = XCreateWindow(_glfw.x11.display, _glfw.x11.root,
+                              0, 0, 1, 1, 0, 0,
+                              InputOnly,
+                              DefaultVisual(_glfw.x11.display, _glfw.x11.screen),
+                              CWEventMask, &wa);
+
+    XConvertSelection(_glfw.x11.display,
+                      _glfw.x11.CLIPBOARD,
+                      target,
+                      _glfw.x11.GLFW_SELECTION,
+                      requestor,
+                      CurrentTime);
+
+    while (!XCheckTypedWindowEvent(_glfw.x11.display,
+                                   requestor,
+                                   SelectionNotify,
+                                   &notification))
+    {
+        waitForEvent(NULL);
+    }
+
+    if (notification.xselection.property == None)
+    {
+        _glfwInputError(GLFW_FORMAT_UNAVAILABLE,
+                        "X11: Failed to convert selection to %s", mime);
+    }
+    else
+    {
+        unsigned char* data = NULL;
+        Atom actualType = None;
+        int actualFormat;
+        unsigned long itemCount, bytesAfter;
+
+        XCheckIfEvent(_glfw.x11.display,
+                      &dummy,
+                      isSelPropNewValueNotify,
+                      (XPointer) &notification);
+
+        // Only the type is needed to tell an INCR transfer from the data
+        XGetWindowProperty(_glfw.x11.display,
+                           requestor,
+                           notification.xselection.property,
+                           0,
+                           0,
+                           False,
+                           AnyPropertyType,
+                           &actualType,
+                           &actualFormat,
+                           &itemCount,
+                           &bytesAfter,
+                           &data);
+
+        if (data)
+            XFree(data);
+
+        if (actualType == _glfw.x11.INCR)
+        {
+            // Deleting the INCR property asks the owner for the first chunk
+            XDeleteProperty(_glfw.x11.display,
+                            requestor,
+                            notification.xselection.property);
+
+            for (;;)
+            {
+                while (!XCheckIfEvent(_glfw.x11.display,
+                                      &dummy,
+                                      isSelPropNewValueNotify,
+                                      (XPointer) &notification))
+                {
+                    waitForEvent(NULL);
+                }
+
+                // Reading and deleting each chunk asks for the next one, until
+                // the owner ends the transfer with an empty chunk
+                if (!streamSelectionProperty(requestor,
+                                             notification.xselection.property,
+                                             callback, user, &size))
+                {
+                    break;
+                }
+
+                if (!size)
+                {
+                    result = GLFW_TRUE;
+                    break;
+                }
+            }
+        }
+        else
+        {
+            result = streamSelectionProperty(requestor,
+                                             notification.xselection.property,
+                                             callback, user, &size);
+        }
+    }
+
+    XDestroyWindow(_glfw.x11.display, requestor);
+    XFlush(_glfw.x11.display);
+    return result;
+}
+
 void _glfwPlatformGetRequiredInstanceExtensions(char** extensions)
 {
     if (!_glfw.vk.KHR_surface)
@@ -3170,6 +5421,7 @@ GLFWAPI void glfwSetX11SelectionString(const char* string)
 {
     _GLFW_REQUIRE_INIT();
 
+    cancelTransfers(_glfw.x11.PRIMARY);
     free(_glfw.x11.primarySelectionString);
     _glfw.x11.primarySelectionString = _glfw_strdup(string);
 
@@ -51,15 +51,19 @@ typedef struct
     GLFWwindow* window;
     int number;
     int closeable;
+    double xscroll, yscroll;
 } Slot;
 
 static void usage(void)
 {
-    printf("Usage: events [-f] [-h] [-n WINDOWS]\n");
+    printf("Usage: events [-c] [-f] [-h] [-n WINDOWS] [-r FILE | -p FILE]\n");
     printf("Options:\n");
+    printf("  -c coalesce window and scroll events\n");
     printf("  -f use full screen\n");
     printf("  -h show this help\n");
     printf("  -n the number of windows to create\n");
+    printf("  -r record input to the specified file\n");
+    printf("  -p replay input from the specified file\n");
 }
 
 static const char* get_key_name(int key)
@@ -386,8 +390,11 @@ static void cursor_enter_callback(GLFWwindow* window, int entered)
 static void scroll_callback(GLFWwindow* window, double x, double y)
 {
     Slot* slot = glfwGetWindowUserPointer(window);
-    printf("%08x to %i at %0.3f: Scroll: %0.3f %0.3f\n",
-           counter++, slot->number, glfwGetTime(), x, y);
+    slot->xscroll += x;
+    slot->yscroll += y;
+    printf("%08x to %i at %0.3f: Scroll: %0.3f %0.3f (total %0.3f %0.3f)\n",
+           counter++, slot->number, glfwGetTime(), x, y,
+           slot->xscroll, slot->yscroll);
 }
 
 static void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
@@ -515,6 +522,8 @@ int main(int argc, char** argv)
 {
     Slot* slots;
     GLFWmonitor* monitor = NULL;
+    const char* recordPath = NULL;
+    const char* replayPath = NULL;
     int ch, i, width, height, count = 1;
 
     glfwSetErrorCallback(error_callback);
@@ -527,10 +536,14 @@ int main(int argc, char** argv)
     glfwSetMonitorCallback(monitor_callback);
     glfwSetJoystickCallback(joystick_callback);
 
-    while ((ch = getopt(argc, argv, "hfn:")) != -1)
+    while ((ch = getopt(argc, argv, "chfn:p:r:")) != -1)
     {
         switch (ch)
         {
+            case 'c':
+                glfwWindowHint(GLFW_COALESCE_EVENTS, GLFW_TRUE);
+                break;
+
             case 'h':
                 usage();
                 exit(EXIT_SUCCESS);
@@ -543,6 +556,14 @@ int main(int argc, char** argv)
                 count = (int) strtoul(optarg, NULL, 10);
                 break;
 
+            case 'p':
+                replayPath = optarg;
+                break;
+
+            case 'r':
+                recordPath = optarg;
+                break;
+
             default:
                 usage();
                 exit(EXIT_FAILURE);
@@ -624,6 +645,32 @@ int main(int argc, char** argv)
         glfwSwapInterval(1);
     }
 
+    // Only the events passed on to the application are recorded, so replaying
+    // a recording made with -c must give the same scroll totals as printed
+    // while recording
+    if (recordPath)
+    {
+        if (!glfwStartInputRecording(recordPath))
+        {
+            free(slots);
+            glfwTerminate();
+            exit(EXIT_FAILURE);
+        }
+
+        printf("Recording input to %s\n", recordPath);
+    }
+    else if (replayPath)
+    {
+        if (!glfwStartInputReplay(replayPath, GLFW_REPLAY_RECORDED_SPEED))
+        {
+            free(slots);
+            glfwTerminate();
+            exit(EXIT_FAILURE);
+        }
+
+        printf("Replaying input from %s\n", replayPath);
+    }
+
     printf("Main loop starting\n");
 
     for (;;)
@@ -637,12 +684,24 @@ int main(int argc, char** argv)
         if (i < count)
             break;
 
+        if (replayPath && !glfwInputReplayActive())
+        {
+            printf("Replay finished\n");
+            replayPath = NULL;
+        }
+
         glfwWaitEvents();
 
         // Workaround for an issue with msvcrt and mintty
         fflush(stdout);
     }
 
+    for (i = 0;  i < count;  i++)
+    {
+        printf("Window %i scroll total: %0.3f %0.3f\n",
+               slots[i].number, slots[i].xscroll, slots[i].yscroll);
+    }
+
     free(slots);
     glfwTerminate();
     exit(EXIT_SUCCESS);